@@ -6,13 +6,26 @@
 #include <DrawDebugHelpers.h>
 #include <Particles/ParticleSystemComponent.h>
 #include <AdvancedShooter/AI/EnemyController.h>
-#include <BehaviorTree/BlackboardComponent.h>
-#include <BehaviorTree/BehaviorTreeComponent.h>
+#include <AdvancedShooter/AI/EnemySignificanceSubsystem.h>
+#include <AdvancedShooter/AI/EnemySpawnerSubsystem.h>
+#include <AdvancedShooter/AI/EnemyBehaviorTreeComponent.h>
+#include <GameFramework/CharacterMovementComponent.h>
 #include <Components/SphereComponent.h>
 #include <AdvancedShooter/ShooterCharacter.h>
 #include <Components/CapsuleComponent.h>
 #include <Components/BoxComponent.h>
 #include <Engine/SkeletalMeshSocket.h>
+#include <AdvancedShooter/Effects/ParticlePoolSubsystem.h>
+#include <AdvancedShooter/Combat/DamagePipelineSubsystem.h>
+#include <AdvancedShooter/Data/DataTableRegistry.h>
+#include <AdvancedShooter/Data/AssetStreamingSubsystem.h>
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarDrawPatrolPoints(
+	TEXT("Shooter.Enemy.DrawPatrolPoints"),
+	0,
+	TEXT("1: draw each enemys patrol points for a few seconds whenever it starts its behavior."),
+	ECVF_Cheat);
 
 // Sets default values
 AEnemy::AEnemy()
@@ -31,6 +44,9 @@ AEnemy::AEnemy()
 
 	rightWeaponCollision = CreateDefaultSubobject<UBoxComponent>(TEXT("Right Weapon Collision"));
 	rightWeaponCollision->SetupAttachment(GetMesh(), FName("RightWeaponBone"));
+
+	// Spawned by the enemy spawner as well as placed
+	AutoPossessAI = EAutoPossessAI::PlacedInWorldOrSpawned;
 }
 
 // Called when the game starts or when spawned
@@ -61,23 +77,136 @@ void AEnemy::BeginPlay()
 	GetCapsuleComponent()->SetCollisionResponseToChannel(ECollisionChannel::ECC_Camera, ECollisionResponse::ECR_Ignore);
 	health = maxHealth;
 
+	BuildHitZones();
+
 	// Get the ai controller
 	enemyController = Cast<AEnemyController>(GetController());
 
-	enemyController->GetBlackboardComponent()->SetValueAsBool(FName("CanAttack"), true);
+	if (UEnemySignificanceSubsystem* significance = GetWorld()->GetSubsystem<UEnemySignificanceSubsystem>())
+	{
+		significance->AddEnemy(this);
+	}
 
+	StartBehavior();
+}
+
+void AEnemy::StartBehavior()
+{
 	// Convert local patrol point to world patrol point
 	const FVector worldPatrolPoint = UKismetMathLibrary::TransformLocation(GetActorTransform(), patrolPoint);
 	const FVector worldPatrolPoint2 = UKismetMathLibrary::TransformLocation(GetActorTransform(), patrolPoint2);
-	DrawDebugSphere(GetWorld(), worldPatrolPoint, 25.f, 12, FColor::Red, true);
-	DrawDebugSphere(GetWorld(), worldPatrolPoint2, 25.f, 12, FColor::Red, true);
-	
+
+	// Not persistent, pooled enemies start their behavior again on every reuse
+	if (CVarDrawPatrolPoints.GetValueOnGameThread() != 0)
+	{
+		DrawDebugSphere(GetWorld(), worldPatrolPoint, 25.f, 12, FColor::Red, false, 5.f);
+		DrawDebugSphere(GetWorld(), worldPatrolPoint2, 25.f, 12, FColor::Red, false, 5.f);
+	}
+
 	if (!enemyController) return;
-	enemyController->GetBlackboardComponent()->SetValueAsVector(TEXT("PatrolPoint"), worldPatrolPoint);
-	enemyController->GetBlackboardComponent()->SetValueAsVector(TEXT("PatrolPoint2"), worldPatrolPoint2);
+	enemyController->SetCanAttack(true);
+	enemyController->SetPatrolPoints(worldPatrolPoint, worldPatrolPoint2);
 	enemyController->RunBehaviorTree(behaviorTree);
 }
 
+void AEnemy::SetEnemyRows(EEnemyType type, EEnemyLevel _level)
+{
+	enemyType = type;
+	enemyLevel = _level;
+}
+
+void AEnemy::ResetFromPool(const FTransform& transform, EEnemyLevel _level)
+{
+	// Collision first so the teleport sees the capsule, then moved clear of enemies already on the spawn point
+	// the same way a fresh spawn is adjusted, and dropped on the point anyway when there is no room
+	SetActorEnableCollision(true);
+	SetActorScale3D(transform.GetScale3D());
+
+	if (!TeleportTo(transform.GetLocation(), transform.Rotator()))
+	{
+		SetActorTransform(transform, false, NULL, ETeleportType::ResetPhysics);
+	}
+
+	SetActorHiddenInGame(false);
+	SetActorTickEnabled(true);
+
+	if (enemyLevel != _level)
+	{
+		enemyLevel = _level;
+		SetEnemyLevelData();
+	}
+
+	health = maxHealth;
+	bIsDying = false;
+	bIsStunned = false;
+	bIsInAttackRange = false;
+	bCanAttack = true;
+	bCanHitReact = true;
+
+	GetMesh()->SetComponentTickEnabled(true);
+
+	GetCharacterMovement()->SetComponentTickEnabled(true);
+	GetCharacterMovement()->SetMovementMode(EMovementMode::MOVE_Walking);
+
+	// Lost if the controller was destroyed while the enemy was dormant
+	if (!GetController()) SpawnDefaultController();
+	enemyController = Cast<AEnemyController>(GetController());
+
+	if (enemyController) enemyController->ResetBlackboard();
+
+	if (UEnemySignificanceSubsystem* significance = GetWorld()->GetSubsystem<UEnemySignificanceSubsystem>())
+	{
+		significance->AddEnemy(this);
+	}
+
+	StartBehavior();
+}
+
+void AEnemy::ReturnToPool()
+{
+	GetWorldTimerManager().ClearAllTimersForObject(this);
+
+	if (GetAnimInstance()) GetAnimInstance()->StopAllMontages(0.f);
+	HideHealthBar();
+
+	DeactivateLeftWeapon();
+	DeactivateRightWeapon();
+
+	if (enemyController)
+	{
+		enemyController->StopMovement();
+
+		if (UEnemyBehaviorTreeComponent* behaviorTreeComponent = enemyController->GetBehaviorTreeComponent())
+		{
+			behaviorTreeComponent->StopTree(EBTStopMode::Forced);
+		}
+	}
+
+	if (UEnemySignificanceSubsystem* significance = GetWorld()->GetSubsystem<UEnemySignificanceSubsystem>())
+	{
+		significance->RemoveEnemy(this);
+	}
+
+	GetCharacterMovement()->StopMovementImmediately();
+	GetCharacterMovement()->DisableMovement();
+	GetCharacterMovement()->SetComponentTickEnabled(false);
+	GetMesh()->SetComponentTickEnabled(false);
+
+	SetActorTickEnabled(false);
+	SetActorEnableCollision(false);
+	SetActorHiddenInGame(true);
+}
+
+void AEnemy::EndPlay(const EEndPlayReason::Type endPlayReason)
+{
+	if (UEnemySignificanceSubsystem* significance = GetWorld()->GetSubsystem<UEnemySignificanceSubsystem>())
+	{
+		significance->RemoveEnemy(this);
+	}
+
+	Super::EndPlay(endPlayReason);
+}
+
 void AEnemy::OnConstruction(const FTransform& transform)
 {
 	Super::OnConstruction(transform);
@@ -88,9 +217,6 @@ void AEnemy::OnConstruction(const FTransform& transform)
 void AEnemy::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
-
-	if (bIsDying) return;
-	UpdateDamageNumbers();
 }
 
 // Called to bind functionality to input
@@ -99,92 +225,83 @@ void AEnemy::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
 	Super::SetupPlayerInputComponent(PlayerInputComponent);
 
 }
-UDataTable* AEnemy::GetDataTable(FString path)
+
+void AEnemy::SetEnemyData()
 {
-	UDataTable* tableObject = Cast<UDataTable>(StaticLoadObject(UDataTable::StaticClass(), NULL, *path));
+	UDataTableRegistry* registry = UDataTableRegistry::Get();
+	if (!registry) return;
 
-	if (!tableObject) return NULL;
+	const FEnemyDataTable* enemyDataRow = registry->GetEnemyRow(enemyType);
+	if (!enemyDataRow) return;
+
+	stunChance = enemyDataRow->stunChance;
+	attackWaitTime = enemyDataRow->attackWaitTime;
 
-	return tableObject;
+	headBoneName = enemyDataRow->headBoneName;
+	limbBoneNames = enemyDataRow->limbBoneNames;
+	headDamageMultiplier = enemyDataRow->headDamageMultiplier;
+	torsoDamageMultiplier = enemyDataRow->torsoDamageMultiplier;
+	limbDamageMultiplier = enemyDataRow->limbDamageMultiplier;
+
+	// Keeps the blueprints mesh until the rows assets have streamed in
+	TArray<FSoftObjectPath> assetPaths;
+	enemyDataRow->GetAssetPaths(assetPaths);
+
+	UAssetStreamingSubsystem::RequestAssets(this, EGameDataTable::EGDT_Enemy, (uint8)enemyType, assetPaths,
+		FSimpleDelegate::CreateUObject(this, &AEnemy::SetEnemyAssets));
 }
 
-void AEnemy::SetEnemyData()
+void AEnemy::SetEnemyAssets()
 {
-	FEnemyDataTable* enemyDataRow = NULL;
+	UDataTableRegistry* registry = UDataTableRegistry::Get();
+	if (!registry) return;
 
-	switch (enemyType)
-	{
-		case EEnemyType::EET_Grux:
-			enemyDataRow = GetDataTable(ENEMYPATH)->FindRow<FEnemyDataTable>(FName("Grux"), TEXT(""));
-			break;
+	const FEnemyDataTable* enemyDataRow = registry->GetEnemyRow(enemyType);
+	if (!enemyDataRow) return;
 
-		case EEnemyType::EET_Khaimera:
-			enemyDataRow = GetDataTable(ENEMYPATH)->FindRow<FEnemyDataTable>(FName("Khaimera"), TEXT(""));
-			break;
+	GetMesh()->SetSkeletalMesh(enemyDataRow->enemyMesh.Get());
+	GetMesh()->SetAnimInstanceClass(enemyDataRow->animBP.Get());
 
-		default:
-			break;
-	}
+	impactParticles = enemyDataRow->impactParicles.Get();
 
-	if (!enemyDataRow) return;
-	stunChance = enemyDataRow->stunChance;
-	attackWaitTime = enemyDataRow->attackWaitTime;
+	impactSound = enemyDataRow->impactSound.Get();
+	meleeImpactSound = enemyDataRow->meleeImpactSound.Get();
 
-	headBoneName = enemyDataRow->headBoneName;
+	attackMontage = enemyDataRow->attackMontage.Get();
+	hitMontage = enemyDataRow->hitMontage.Get();
+	deathMontage = enemyDataRow->deathMontage.Get();
 
-	GetMesh()->SetSkeletalMesh(enemyDataRow->enemyMesh);
-	GetMesh()->SetAnimInstanceClass(enemyDataRow->animBP);
+	// Bodies moved with the new mesh
+	if (HasActorBegunPlay()) BuildHitZones();
+}
 
-	impactParticles = enemyDataRow->impactParicles;
+void FEnemyDataTable::GetAssetPaths(TArray<FSoftObjectPath>& outPaths) const
+{
+	AddAssetPath(enemyMesh, outPaths);
+	AddAssetPath(impactParicles, outPaths);
+	AddAssetPath(impactSound, outPaths);
+	AddAssetPath(meleeImpactSound, outPaths);
+	AddAssetPath(animBP, outPaths);
+	AddAssetPath(hitMontage, outPaths);
+	AddAssetPath(attackMontage, outPaths);
+	AddAssetPath(deathMontage, outPaths);
+}
 
-	impactSound = enemyDataRow->impactSound;
-	meleeImpactSound = enemyDataRow->meleeImpactSound;
+void AEnemy::BuildHitZones()
+{
+	hitZones.Build(GetMesh(), headBoneName, limbBoneNames);
 
-	attackMontage = enemyDataRow->attackMontage;
-	hitMontage = enemyDataRow->hitMontage;
-	deathMontage = enemyDataRow->deathMontage;
+	hitZones.SetDamageMultiplier(EHitZone::Head, headDamageMultiplier);
+	hitZones.SetDamageMultiplier(EHitZone::Torso, torsoDamageMultiplier);
+	hitZones.SetDamageMultiplier(EHitZone::Limb, limbDamageMultiplier);
 }
 
 void AEnemy::SetEnemyLevelData()
 {
-	FEnemyLevelDataTable* enemyLevelDataRow = NULL;
-
-	switch (enemyLevel)
-	{
-	case EEnemyLevel::EEL_Level1:
-		enemyLevelDataRow = GetDataTable(ENEMYLEVELPATH)->FindRow<FEnemyLevelDataTable>(FName("Level1"), TEXT(""));
-		break;
-	case EEnemyLevel::EEL_Level2:
-		enemyLevelDataRow = GetDataTable(ENEMYLEVELPATH)->FindRow<FEnemyLevelDataTable>(FName("Level2"), TEXT(""));
-		break;
-	case EEnemyLevel::EEL_Level3:
-		enemyLevelDataRow = GetDataTable(ENEMYLEVELPATH)->FindRow<FEnemyLevelDataTable>(FName("Level3"), TEXT(""));
-		break;
-	case EEnemyLevel::EEL_Level4:
-		enemyLevelDataRow = GetDataTable(ENEMYLEVELPATH)->FindRow<FEnemyLevelDataTable>(FName("Level4"), TEXT(""));
-		break;
-	case EEnemyLevel::EEL_Level5:
-		enemyLevelDataRow = GetDataTable(ENEMYLEVELPATH)->FindRow<FEnemyLevelDataTable>(FName("Level5"), TEXT(""));
-		break;
-	case EEnemyLevel::EEL_Level6:
-		enemyLevelDataRow = GetDataTable(ENEMYLEVELPATH)->FindRow<FEnemyLevelDataTable>(FName("Level6"), TEXT(""));
-		break;
-	case EEnemyLevel::EEL_Level7:
-		enemyLevelDataRow = GetDataTable(ENEMYLEVELPATH)->FindRow<FEnemyLevelDataTable>(FName("Level7"), TEXT(""));
-		break;
-	case EEnemyLevel::EEL_Level8:
-		enemyLevelDataRow = GetDataTable(ENEMYLEVELPATH)->FindRow<FEnemyLevelDataTable>(FName("Level8"), TEXT(""));
-		break;
-	case EEnemyLevel::EEL_Level9:
-		enemyLevelDataRow = GetDataTable(ENEMYLEVELPATH)->FindRow<FEnemyLevelDataTable>(FName("Level9"), TEXT(""));
-		break;
-	case EEnemyLevel::EEL_Level10:
-		enemyLevelDataRow = GetDataTable(ENEMYLEVELPATH)->FindRow<FEnemyLevelDataTable>(FName("Level10"), TEXT(""));
-		break;
-	default:
-		break;
-	}
+	UDataTableRegistry* registry = UDataTableRegistry::Get();
+	if (!registry) return;
 
+	const FEnemyLevelDataTable* enemyLevelDataRow = registry->GetEnemyLevelRow(enemyLevel);
 	if (!enemyLevelDataRow) return;
 
 	maxHealth = enemyLevelDataRow->health;
@@ -194,6 +311,61 @@ void AEnemy::SetEnemyLevelData()
 	UE_LOG(LogTemp, Warning, TEXT("Lvl %f"), level);
 }
 
+bool AEnemy::HotApplyEnemyData()
+{
+	UDataTableRegistry* registry = UDataTableRegistry::Get();
+	if (!registry) return false;
+
+	const FEnemyDataTable* oldRow = registry->GetPreviousEnemyRow(enemyType);
+	const FEnemyDataTable* newRow = registry->GetEnemyRow(enemyType);
+	if (!oldRow || !newRow) return false;
+
+	bool bChanged = false;
+
+	if (newRow->attackWaitTime != oldRow->attackWaitTime)
+	{
+		attackWaitTime = newRow->attackWaitTime;
+		bChanged = true;
+	}
+
+	if (newRow->stunChance != oldRow->stunChance)
+	{
+		stunChance = newRow->stunChance;
+		bChanged = true;
+	}
+
+	return bChanged;
+}
+
+bool AEnemy::HotApplyEnemyLevelData()
+{
+	UDataTableRegistry* registry = UDataTableRegistry::Get();
+	if (!registry) return false;
+
+	const FEnemyLevelDataTable* oldRow = registry->GetPreviousEnemyLevelRow(enemyLevel);
+	const FEnemyLevelDataTable* newRow = registry->GetEnemyLevelRow(enemyLevel);
+	if (!oldRow || !newRow) return false;
+
+	bool bChanged = false;
+
+	if (newRow->health != oldRow->health && newRow->health > 0.f)
+	{
+		// Keep the same fraction of health so a wounded enemy stays wounded
+		const float healthFraction = maxHealth > 0.f ? health / maxHealth : 1.f;
+		maxHealth = newRow->health;
+		health = maxHealth * healthFraction;
+		bChanged = true;
+	}
+
+	if (newRow->damage != oldRow->damage)
+	{
+		baseDamage = newRow->damage;
+		bChanged = true;
+	}
+
+	return bChanged;
+}
+
 void AEnemy::ShowHealthBar_Implementation()
 {
 	GetWorldTimerManager().ClearTimer(healthBarTimer);
@@ -212,7 +384,7 @@ void AEnemy::Die()
 	GetAnimInstance()->Montage_Play(deathMontage);
 
 	if (!enemyController) return;
-	enemyController->GetBlackboardComponent()->SetValueAsBool(TEXT("Dead"), true);
+	enemyController->SetDead(true);
 
 	enemyController->StopMovement();
 }
@@ -244,7 +416,7 @@ void AEnemy::PlayAttackMontage(FName section, float playRate)
 	GetWorldTimerManager().SetTimer(attackWaitTimer, this, &AEnemy::ResetCanAttack, attackWaitTime);
 
 	if (!enemyController) return;
-	enemyController->GetBlackboardComponent()->SetValueAsBool(FName("CanAttack"), false);
+	enemyController->SetCanAttack(false);
 }
 
 FName AEnemy::GetAttackSectionName()
@@ -279,40 +451,6 @@ void AEnemy::ResetHitReactTimer()
 	bCanHitReact = true;
 }
 
-void AEnemy::StoreDamageNumber(UUserWidget* damageNumber, FVector location)
-{
-	damageNumbers.Add(damageNumber, location);
-
-	FTimerHandle damageNumberTimer;
-
-	// Create a local timer delegate to bind to our ufunction
-	FTimerDelegate damageNumberDelegate;
-
-	damageNumberDelegate.BindUFunction(this, FName("DestroyDamageNumber"), damageNumber);
-
-	GetWorldTimerManager().SetTimer(damageNumberTimer, damageNumberDelegate, damageNumberDestroyTime, false);
-}
-
-void AEnemy::UpdateDamageNumbers()
-{
-	for (TPair<UUserWidget*, FVector> damagePair : damageNumbers)
-	{
-		UUserWidget* damageNumber = damagePair.Key;
-		const FVector location = damagePair.Value;
-
-		// Out param of project screen to world
-		FVector2D screenPosition;
-		UGameplayStatics::ProjectWorldToScreen(GetWorld()->GetFirstPlayerController(), location, screenPosition);
-		damageNumber->SetPositionInViewport(screenPosition);
-	}
-}
-
-void AEnemy::DestroyDamageNumber(UUserWidget* damageNumber)
-{
-	damageNumbers.Remove(damageNumber);
-	damageNumber->RemoveFromParent();
-}
-
 void AEnemy::BulletHit_Implementation(FHitResult hitResult, AActor* shooter, AController* instigator)
 {
 	if (impactSound)
@@ -322,7 +460,7 @@ void AEnemy::BulletHit_Implementation(FHitResult hitResult, AActor* shooter, ACo
 	
 	if (impactParticles)
 	{
-		UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), impactParticles, hitResult.ImpactPoint, FRotator::ZeroRotator, true);
+		UParticlePoolSubsystem::SpawnPooledEmitter(this, impactParticles, hitResult.ImpactPoint);
 	}
 }
 
@@ -372,9 +510,10 @@ void AEnemy::CombatRangeOverlap(UPrimitiveComponent* overlappedComponent, AActor
 	if (character)
 	{
 		bIsInAttackRange = true;
+		UEnemySignificanceSubsystem::Wake(this);
 
 		if (!enemyController) return;
-		enemyController->GetBlackboardComponent()->SetValueAsBool(TEXT("InAttackRange"), true);
+		enemyController->SetInAttackRange(true);
 	}
 }
 
@@ -389,20 +528,27 @@ void AEnemy::CombatRangeEndOverlap(UPrimitiveComponent* overlappedComponent, AAc
 		bIsInAttackRange = false;
 
 		if (!enemyController) return;
-		enemyController->GetBlackboardComponent()->SetValueAsBool(TEXT("InAttackRange"), false);
+		enemyController->SetInAttackRange(false);
 	}
 }
 
 void AEnemy::FinishDeath()
 {
-	Destroy();
+	// Placed enemies are destroyed, spawned ones go back to their pool
+	UEnemySpawnerSubsystem::ReleasePooledEnemy(this);
 }
 
 void AEnemy::DoDamage(AShooterCharacter* character)
 {
 	if (!character) return;
 
-	UGameplayStatics::ApplyDamage(character, baseDamage, enemyController, this, UDamageType::StaticClass());
+	FQueuedDamage damage;
+	damage.target = character;
+	damage.instigator = enemyController;
+	damage.causer = this;
+	damage.amount = baseDamage;
+
+	UDamagePipelineSubsystem::QueueDamage(this, damage);
 	UGameplayStatics::PlaySoundAtLocation(GetWorld(), meleeImpactSound, character->GetActorLocation());
 }
 
@@ -421,7 +567,9 @@ void AEnemy::StunCharacter(AShooterCharacter* character)
 void AEnemy::ResetCanAttack()
 {
 	bCanAttack = true;
-	enemyController->GetBlackboardComponent()->SetValueAsBool(FName("CanAttack"), true);
+
+	if (!enemyController) return;
+	enemyController->SetCanAttack(true);
 }
 
 void AEnemy::OnLeftWeaponBeginOverlap(UPrimitiveComponent* overlappedComponent, AActor* otherActor, UPrimitiveComponent* otherComp, int32 otherBodyIndex, bool bFromSweep, const FHitResult& sweepResult)
@@ -454,7 +602,7 @@ void AEnemy::SpawnBloodParticle(AShooterCharacter* character, FName socketName)
 	const FTransform socketTransfom = tipSocket->GetSocketTransform(GetMesh());
 	if (!character->GetBloodParticles()) return;
 
-	UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), character->GetBloodParticles(), socketTransfom);
+	UParticlePoolSubsystem::SpawnPooledEmitter(this, character->GetBloodParticles(), socketTransfom);
 }
 
 void AEnemy::ActivateLeftWeapon()
@@ -480,9 +628,10 @@ void AEnemy::DeactivateRightWeapon()
 void AEnemy::SetIsStunned(bool stunned)
 {
 	bIsStunned = stunned;
+	if (stunned) UEnemySignificanceSubsystem::Wake(this);
 
 	if (!enemyController) return;
-	enemyController->GetBlackboardComponent()->SetValueAsBool(TEXT("Stunned"), stunned);
+	enemyController->SetStunned(stunned);
 }
 
 void AEnemy::SetTarget(AActor* target)
@@ -493,8 +642,11 @@ void AEnemy::SetTarget(AActor* target)
 
 	if (character)
 	{
+		// Agro and hits both land here, the enemy has to react at full rate
+		UEnemySignificanceSubsystem::Wake(this);
+
 		// Set the value of the target
-		enemyController->GetBlackboardComponent()->SetValueAsObject(TEXT("Target"), character);
+		enemyController->SetTarget(character);
 	}
 }
 
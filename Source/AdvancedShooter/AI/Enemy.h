@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
 #include <AdvancedShooter/BulletHitInterface.h>
+#include <AdvancedShooter/Combat/HitZoneTable.h>
 #include <Engine/DataTable.h>
 #include "Enemy.generated.h"
 
@@ -16,9 +17,6 @@ class USphereComponent;
 class UBoxComponent;
 class AShooterCharacter;
 
-const FString ENEMYLEVELPATH = TEXT("DataTable'/Game/_Game/DataTable/DT_EnemyLevel.DT_EnemyLevel'"); // NOT FINISHED
-const FString ENEMYPATH = TEXT("DataTable'/Game/_Game/DataTable/DT_Enemy.DT_Enemy'"); 
-
 UENUM(BlueprintType)
 enum class EEnemyType : uint8
 {
@@ -71,31 +69,48 @@ struct FEnemyDataTable : public FTableRowBase
 	float attackWaitTime;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	FString headBoneName;
+	FName headBoneName;
 
+	// Bones that count as limbs, their child bones are limbs too
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	USkeletalMesh* enemyMesh;
+	TArray<FName> limbBoneNames;
 
+	// Scales the weapons head shot damage
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	UParticleSystem* impactParicles;
+	float headDamageMultiplier = 1.f;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	USoundBase* impactSound;
+	float torsoDamageMultiplier = 1.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float limbDamageMultiplier = 1.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TSoftObjectPtr<USkeletalMesh> enemyMesh;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TSoftObjectPtr<UParticleSystem> impactParicles;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TSoftObjectPtr<USoundBase> impactSound;
 	
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	USoundBase* meleeImpactSound;
+	TSoftObjectPtr<USoundBase> meleeImpactSound;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	TSubclassOf<UAnimInstance> animBP;
+	TSoftClassPtr<UAnimInstance> animBP;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	UAnimMontage* hitMontage;
+	TSoftObjectPtr<UAnimMontage> hitMontage;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	UAnimMontage* attackMontage;
+	TSoftObjectPtr<UAnimMontage> attackMontage;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	UAnimMontage* deathMontage;
+	TSoftObjectPtr<UAnimMontage> deathMontage;
+
+	// Soft references for the streaming subsystem to load together
+	void GetAssetPaths(TArray<FSoftObjectPath>& outPaths) const;
 };
 
 UCLASS()
@@ -117,31 +132,58 @@ public:
 
 	virtual float TakeDamage(float damageAmount, struct FDamageEvent const& damageEvent, AController* eventInstigator, AActor* damageCauser) override;
 
-	FString GetHeadBoneName() const { return headBoneName; }
+	FName GetHeadBoneName() const { return headBoneName; }
+
+	// Which part of the body the hit landed on
+	EHitZone GetHitZone(const FHitResult& hitResult) const { return hitZones.Resolve(hitResult); }
+	float GetHitZoneDamageMultiplier(EHitZone zone) const { return hitZones.GetDamageMultiplier(zone); }
 	UBehaviorTree* GetBehaviorTree() const { return behaviorTree; }
+	AEnemyController* GetEnemyController() const { return enemyController; }
+	bool IsInAttackRange() const { return bIsInAttackRange; }
 	UAnimInstance* GetAnimInstance() const { return GetMesh()->GetAnimInstance(); }
 	UFUNCTION(BlueprintPure)
 	FName GetAttackSectionName();
 
-	UFUNCTION(BlueprintImplementableEvent)
-	void ShowDamageNumber(int32 damage, FVector hitLocation, bool bIsHeadShot);
-
 	UFUNCTION(BlueprintCallable)
 	void SetIsStunned(bool stunned);
 
+	// Copy tuning fields that changed in the enemy and enemy level tables into this enemy, true if any did
+	bool HotApplyEnemyData();
+	bool HotApplyEnemyLevelData();
+
 	void SetTarget(AActor* target);
 
+	// ENEMY POOL, see UEnemySpawnerSubsystem
+	EEnemyType GetEnemyType() const { return enemyType; }
+	EEnemyLevel GetEnemyLevel() const { return enemyLevel; }
+
+	// Only before FinishSpawning, construction reads the rows
+	void SetEnemyRows(EEnemyType type, EEnemyLevel _level);
+
+	// Brings a dormant enemy back at full health with a fresh blackboard and behavior tree
+	void ResetFromPool(const FTransform& transform, EEnemyLevel _level);
+
+	// Hides the enemy and stops everything it runs until it is acquired again, the controller stays possessing it
+	void ReturnToPool();
+
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type endPlayReason) override;
 	virtual void OnConstruction(const FTransform& transform) override;
 
-	UDataTable* GetDataTable(FString path);
-	UDataTable* GetEnemyDataTable();
+	// Rows come from the baked tables in the data table registry
 	void SetEnemyData();
-
-	UDataTable* GetEnemyLevelDataTable();
 	void SetEnemyLevelData();
+
+	// Applies the rows streamed mesh, sounds and montages
+	void SetEnemyAssets();
+
+	// Builds the bone to hit zone lookup for the current mesh
+	void BuildHitZones();
+
+	// Patrol points, blackboard defaults and the behavior tree, for a new or reused enemy
+	void StartBehavior();
 	
 	// Fuction to be used in blueprint
 	UFUNCTION(BlueprintNativeEvent)
@@ -162,14 +204,6 @@ protected:
 
 	void ResetHitReactTimer();
 
-	UFUNCTION(BlueprintCallable)
-	void StoreDamageNumber(UUserWidget* damageNumber, FVector location);
-
-	void UpdateDamageNumbers();
-
-	UFUNCTION()
-	void DestroyDamageNumber(UUserWidget* damageNumber);
-
 	// Called when somthing overlaps with the agro sphere
 	UFUNCTION()
 	void AgroSphereOverlap(UPrimitiveComponent* overlappedComponent, AActor* otherActor, UPrimitiveComponent* otherComp,
@@ -240,7 +274,24 @@ private:
 
 	// Name of the head bone
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat|Health", meta = (AllowPrivateAccess = "true"))
-	FString headBoneName;
+	FName headBoneName;
+
+	// Bones that count as limbs along with their children
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat|Health", meta = (AllowPrivateAccess = "true"))
+	TArray<FName> limbBoneNames;
+
+	// Damage multipliers for each hit zone
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat|Health", meta = (AllowPrivateAccess = "true"))
+	float headDamageMultiplier = 1.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat|Health", meta = (AllowPrivateAccess = "true"))
+	float torsoDamageMultiplier = 1.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat|Health", meta = (AllowPrivateAccess = "true"))
+	float limbDamageMultiplier = 1.f;
+
+	// Hit zone per physics body, built in BeginPlay
+	FHitZoneTable hitZones;
 
 	// Time to display health bar
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat|Health", meta = (AllowPrivateAccess = "true"))
@@ -268,14 +319,6 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat|Hit", meta = (AllowPrivateAccess = "true"))
 	float hitReactTimeMax = 3.f;
 
-	// Map of damage number widgets and their stored location
-	UPROPERTY(VisibleAnywhere, Category = "Combat|Hit", meta = (AllowPrivateAccess = "true"))
-	TMap<UUserWidget*, FVector> damageNumbers;
-
-	// Time before removing a damage number
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat|Hit", meta = (AllowPrivateAccess = "true"))
-	float damageNumberDestroyTime = 1.5f;
-
 	// BEHAVIOR TREE VARS
 	UPROPERTY(EditAnywhere, Category = "BehaviorTree", meta = (AllowPrivateAccess = "true"))
 	UBehaviorTree* behaviorTree;
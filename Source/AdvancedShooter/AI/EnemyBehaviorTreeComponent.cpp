@@ -0,0 +1,21 @@
+#include "EnemyBehaviorTreeComponent.h"
+#include <AdvancedShooter/AdvancedShooter.h>
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Behavior Tree Ticks Throttled"), STAT_BehaviorTreeTicksThrottled, STATGROUP_AdvancedShooter);
+
+void UEnemyBehaviorTreeComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	skippedTime += DeltaTime;
+
+	if (skippedTime < throttleInterval)
+	{
+		INC_DWORD_STAT(STAT_BehaviorTreeTicksThrottled);
+		return;
+	}
+
+	// Waits and cooldowns in the tree count down by the whole skipped time
+	const float elapsed = skippedTime;
+	skippedTime = 0.f;
+
+	Super::TickComponent(elapsed, TickType, ThisTickFunction);
+}
@@ -0,0 +1,30 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "EnemyBehaviorTreeComponent.generated.h"
+
+/*
+Behavior tree component the enemy significance subsystem can slow down. The tree still schedules its own
+ticks, a throttled tick just waits until the interval has passed and then runs with all the time it skipped.
+*/
+UCLASS()
+class ADVANCEDSHOOTER_API UEnemyBehaviorTreeComponent : public UBehaviorTreeComponent
+{
+	GENERATED_BODY()
+
+public:
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	// Least seconds between tree updates, 0 updates whenever the tree asks to
+	void SetThrottleInterval(float interval) { throttleInterval = interval; }
+	float GetThrottleInterval() const { return throttleInterval; }
+
+private:
+	float throttleInterval = 0.f;
+
+	// Time since the tree last updated
+	float skippedTime = 0.f;
+};
@@ -1,16 +1,26 @@
 #include "EnemyController.h"
 #include <BehaviorTree/BlackboardComponent.h>
-#include <BehaviorTree/BehaviorTreeComponent.h>
+#include <AdvancedShooter/AI/EnemyBehaviorTreeComponent.h>
 #include <BehaviorTree/BehaviorTree.h>
+#include <BehaviorTree/Blackboard/BlackboardKeyType_Bool.h>
+#include <BehaviorTree/Blackboard/BlackboardKeyType_Vector.h>
+#include <BehaviorTree/Blackboard/BlackboardKeyType_Object.h>
+#include <AdvancedShooter/AdvancedShooter.h>
 #include <AdvancedShooter/AI/Enemy.h>
 
+DECLARE_DWORD_COUNTER_STAT(TEXT("Blackboard Writes"), STAT_BlackboardWrites, STATGROUP_AdvancedShooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Blackboard Writes Skipped"), STAT_BlackboardWritesSkipped, STATGROUP_AdvancedShooter);
+
 AEnemyController::AEnemyController()
 {
 	blackboardComponent = CreateDefaultSubobject<UBlackboardComponent>(TEXT("Blackboard Component"));
 	if (!blackboardComponent) return;
 
-	behaviorTreeComponent = CreateDefaultSubobject<UBehaviorTreeComponent>(TEXT("Behavior Tree Component"));
+	behaviorTreeComponent = CreateDefaultSubobject<UEnemyBehaviorTreeComponent>(TEXT("Behavior Tree Component"));
 	if (!behaviorTreeComponent) return;
+
+	// RunBehaviorTree only makes its own component when there is no brain yet, this way the tree can be throttled
+	BrainComponent = behaviorTreeComponent;
 }
 
 void AEnemyController::OnPossess(APawn* inPawn)
@@ -27,4 +37,76 @@ void AEnemyController::OnPossess(APawn* inPawn)
 	{
 		blackboardComponent->InitializeBlackboard(*enemy->GetBehaviorTree()->BlackboardAsset);
 	}
+
+	ResolveBlackboardKeys();
+}
+
+void AEnemyController::ResolveBlackboardKeys()
+{
+	canAttackKey = blackboardComponent->GetKeyID(TEXT("CanAttack"));
+	inAttackRangeKey = blackboardComponent->GetKeyID(TEXT("InAttackRange"));
+	stunnedKey = blackboardComponent->GetKeyID(TEXT("Stunned"));
+	deadKey = blackboardComponent->GetKeyID(TEXT("Dead"));
+	characterDeadKey = blackboardComponent->GetKeyID(TEXT("CharacterDead"));
+	targetKey = blackboardComponent->GetKeyID(TEXT("Target"));
+	patrolPointKey = blackboardComponent->GetKeyID(TEXT("PatrolPoint"));
+	patrolPoint2Key = blackboardComponent->GetKeyID(TEXT("PatrolPoint2"));
+}
+
+void AEnemyController::SetPatrolPoints(const FVector& patrolPoint, const FVector& patrolPoint2)
+{
+	SetVector(patrolPointKey, patrolPoint);
+	SetVector(patrolPoint2Key, patrolPoint2);
+}
+
+void AEnemyController::ResetBlackboard()
+{
+	SetInAttackRange(false);
+	SetStunned(false);
+	SetDead(false);
+	SetCharacterDead(false);
+	SetTarget(NULL);
+}
+
+void AEnemyController::SetBool(FBlackboard::FKey key, bool bValue)
+{
+	if (key == FBlackboard::InvalidKey) return;
+
+	if (blackboardComponent->GetValue<UBlackboardKeyType_Bool>(key) == bValue)
+	{
+		INC_DWORD_STAT(STAT_BlackboardWritesSkipped);
+		return;
+	}
+
+	INC_DWORD_STAT(STAT_BlackboardWrites);
+	blackboardComponent->SetValue<UBlackboardKeyType_Bool>(key, bValue);
+}
+
+void AEnemyController::SetVector(FBlackboard::FKey key, const FVector& value)
+{
+	if (key == FBlackboard::InvalidKey) return;
+
+	// An unset vector reads back as the invalid location, so the first write always goes through
+	if (blackboardComponent->GetValue<UBlackboardKeyType_Vector>(key).Equals(value))
+	{
+		INC_DWORD_STAT(STAT_BlackboardWritesSkipped);
+		return;
+	}
+
+	INC_DWORD_STAT(STAT_BlackboardWrites);
+	blackboardComponent->SetValue<UBlackboardKeyType_Vector>(key, value);
+}
+
+void AEnemyController::SetObject(FBlackboard::FKey key, UObject* value)
+{
+	if (key == FBlackboard::InvalidKey) return;
+
+	if (blackboardComponent->GetValue<UBlackboardKeyType_Object>(key) == value)
+	{
+		INC_DWORD_STAT(STAT_BlackboardWritesSkipped);
+		return;
+	}
+
+	INC_DWORD_STAT(STAT_BlackboardWrites);
+	blackboardComponent->SetValue<UBlackboardKeyType_Object>(key, value);
 }
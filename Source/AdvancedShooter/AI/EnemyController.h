@@ -2,10 +2,11 @@
 
 #include "CoreMinimal.h"
 #include "AIController.h"
+#include "BehaviorTree/BehaviorTreeTypes.h"
 #include "EnemyController.generated.h"
 
 class UBlackboardComponent;
-class UBehaviorTreeComponent;
+class UEnemyBehaviorTreeComponent;
 
 UCLASS()
 class ADVANCEDSHOOTER_API AEnemyController : public AAIController
@@ -17,14 +18,42 @@ public:
 	virtual void OnPossess(APawn* inPawn) override;
 
 	UBlackboardComponent* GetBlackboardComponent() const { return blackboardComponent; }
-protected:
+	UEnemyBehaviorTreeComponent* GetBehaviorTreeComponent() const { return behaviorTreeComponent; }
+
+	// Blackboard writes through keys resolved on possess, unchanged values are skipped
+	void SetCanAttack(bool bCanAttack) { SetBool(canAttackKey, bCanAttack); }
+	void SetInAttackRange(bool bInAttackRange) { SetBool(inAttackRangeKey, bInAttackRange); }
+	void SetStunned(bool bStunned) { SetBool(stunnedKey, bStunned); }
+	void SetDead(bool bDead) { SetBool(deadKey, bDead); }
+	void SetCharacterDead(bool bCharacterDead) { SetBool(characterDeadKey, bCharacterDead); }
+	void SetTarget(UObject* target) { SetObject(targetKey, target); }
+	void SetPatrolPoints(const FVector& patrolPoint, const FVector& patrolPoint2);
+
+	// Puts the keys back to how a new enemy starts, for enemies reused from the pool
+	void ResetBlackboard();
 
+protected:
+	void ResolveBlackboardKeys();
 
 private:
+	void SetBool(FBlackboard::FKey key, bool bValue);
+	void SetVector(FBlackboard::FKey key, const FVector& value);
+	void SetObject(FBlackboard::FKey key, UObject* value);
+
 	// Enemies blackboard comp
 	UPROPERTY(BlueprintReadWrite, Category = "AI Behavior", meta = (AllowPrivateAccess = "true"))
 	UBlackboardComponent* blackboardComponent;
 
 	UPROPERTY(BlueprintReadWrite, Category = "AI Behavior", meta = (AllowPrivateAccess = "true"))
-	UBehaviorTreeComponent* behaviorTreeComponent;
+	UEnemyBehaviorTreeComponent* behaviorTreeComponent;
+
+	// Key ids of the enemy blackboard, invalid when the asset doesnt have the key
+	FBlackboard::FKey canAttackKey = FBlackboard::InvalidKey;
+	FBlackboard::FKey inAttackRangeKey = FBlackboard::InvalidKey;
+	FBlackboard::FKey stunnedKey = FBlackboard::InvalidKey;
+	FBlackboard::FKey deadKey = FBlackboard::InvalidKey;
+	FBlackboard::FKey characterDeadKey = FBlackboard::InvalidKey;
+	FBlackboard::FKey targetKey = FBlackboard::InvalidKey;
+	FBlackboard::FKey patrolPointKey = FBlackboard::InvalidKey;
+	FBlackboard::FKey patrolPoint2Key = FBlackboard::InvalidKey;
 };
@@ -0,0 +1,267 @@
+#include "EnemySignificanceSubsystem.h"
+#include <AdvancedShooter/AdvancedShooter.h>
+#include <AdvancedShooter/AI/Enemy.h>
+#include <AdvancedShooter/AI/EnemyController.h>
+#include <AdvancedShooter/AI/EnemyBehaviorTreeComponent.h>
+#include <GameFramework/CharacterMovementComponent.h>
+#include <Camera/PlayerCameraManager.h>
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Enemy Significance Update"), STAT_EnemySignificanceUpdate, STATGROUP_AdvancedShooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Significance Enemies"), STAT_SignificanceEnemies, STATGROUP_AdvancedShooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Significance Enemies Full Rate"), STAT_SignificanceEnemiesFullRate, STATGROUP_AdvancedShooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Significance Bucket Changes"), STAT_SignificanceBucketChanges, STATGROUP_AdvancedShooter);
+
+static TAutoConsoleVariable<int32> CVarSignificance(
+	TEXT("Shooter.Significance.Enabled"),
+	1,
+	TEXT("1: enemies update less often the less they matter to the player.\n")
+	TEXT("0: every enemy uses the first significance bucket."),
+	ECVF_Cheat);
+
+static FAutoConsoleCommandWithWorld DumpSignificanceCommand(
+	TEXT("Shooter.Significance.Dump"),
+	TEXT("Logs how many enemies are in each significance bucket."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* world)
+	{
+		if (!world) return;
+
+		const UEnemySignificanceSubsystem* significance = world->GetSubsystem<UEnemySignificanceSubsystem>();
+		if (!significance) return;
+
+		significance->LogBucketCounts();
+	}));
+
+bool UEnemySignificanceSubsystem::DoesSupportWorldType(EWorldType::Type worldType) const
+{
+	return worldType == EWorldType::Game || worldType == EWorldType::PIE;
+}
+
+void UEnemySignificanceSubsystem::Deinitialize()
+{
+	enemies.Empty();
+	enemyToIndex.Empty();
+	enemyLocations.Empty();
+	enemyEngaged.Empty();
+	enemyBuckets.Empty();
+	bucketCounts.Empty();
+
+	SET_DWORD_STAT(STAT_SignificanceEnemies, 0);
+	SET_DWORD_STAT(STAT_SignificanceEnemiesFullRate, 0);
+
+	Super::Deinitialize();
+}
+
+TStatId UEnemySignificanceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UEnemySignificanceSubsystem, STATGROUP_Tickables);
+}
+
+bool UEnemySignificanceSubsystem::IsSignificanceEnabled()
+{
+	return CVarSignificance.GetValueOnGameThread() != 0;
+}
+
+void UEnemySignificanceSubsystem::AddEnemy(AEnemy* enemy)
+{
+	if (!enemy) return;
+
+	const FObjectKey enemyKey(enemy);
+	if (enemyToIndex.Contains(enemyKey)) return;
+
+	enemyToIndex.Add(enemyKey, enemies.Num());
+
+	FEnemySignificance& entry = enemies.AddDefaulted_GetRef();
+	entry.enemy = enemy;
+	entry.enemyKey = enemyKey;
+
+	if (const USkeletalMeshComponent* mesh = enemy->GetMesh())
+	{
+		entry.defaultAnimTickOption = mesh->VisibilityBasedAnimTickOption;
+	}
+}
+
+void UEnemySignificanceSubsystem::RemoveEnemy(AEnemy* enemy)
+{
+	const int32* index = enemyToIndex.Find(FObjectKey(enemy));
+	if (!index) return;
+
+	RemoveAtSwap(*index);
+}
+
+void UEnemySignificanceSubsystem::WakeEnemy(AEnemy* enemy)
+{
+	const int32* index = enemyToIndex.Find(FObjectKey(enemy));
+	if (!index || buckets.Num() == 0) return;
+
+	FEnemySignificance& entry = enemies[*index];
+	entry.wakeUntil = GetWorld()->GetTimeSeconds() + wakeDuration;
+
+	// Not waiting for the next update, the reaction has to play this frame
+	ApplyBucket(entry, enemy, 0);
+}
+
+void UEnemySignificanceSubsystem::Wake(AEnemy* enemy)
+{
+	UWorld* world = enemy ? enemy->GetWorld() : NULL;
+	UEnemySignificanceSubsystem* significance = world ? world->GetSubsystem<UEnemySignificanceSubsystem>() : NULL;
+	if (!significance) return;
+
+	significance->WakeEnemy(enemy);
+}
+
+void UEnemySignificanceSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_EnemySignificanceUpdate);
+
+	// Destroyed enemies first so every pass below can trust the arrays
+	for (int32 i = enemies.Num() - 1; i >= 0; --i)
+	{
+		if (enemies[i].enemy.IsValid()) continue;
+		RemoveAtSwap(i);
+	}
+
+	const int32 count = enemies.Num();
+	SET_DWORD_STAT(STAT_SignificanceEnemies, count);
+
+	if (count == 0 || buckets.Num() == 0) return;
+
+	const float worldTime = GetWorld()->GetTimeSeconds();
+
+	enemyLocations.SetNumUninitialized(count, false);
+	enemyEngaged.SetNumUninitialized(count, false);
+	enemyBuckets.SetNumUninitialized(count, false);
+
+	// Gather what the scoring needs from the actors
+	for (int32 i = 0; i < count; ++i)
+	{
+		const AEnemy* enemy = enemies[i].enemy.Get();
+
+		enemyLocations[i] = enemy->GetActorLocation();
+		enemyEngaged[i] = enemies[i].wakeUntil > worldTime || enemy->IsInAttackRange();
+	}
+
+	const APlayerController* playerController = GetWorld()->GetFirstPlayerController();
+	const APlayerCameraManager* cameraManager = playerController ? playerController->PlayerCameraManager : NULL;
+
+	if (!cameraManager || !IsSignificanceEnabled())
+	{
+		for (int32 i = 0; i < count; ++i)
+		{
+			enemyBuckets[i] = 0;
+		}
+	}
+
+	else
+	{
+		const FVector cameraLocation = cameraManager->GetCameraLocation();
+		const FVector cameraForward = cameraManager->GetCameraRotation().Vector();
+		const float cosViewCone = FMath::Cos(FMath::DegreesToRadians(FMath::Min(cameraManager->GetFOVAngle() * 0.5f + viewConeMargin, 180.f)));
+
+		const int32 lastBucket = buckets.Num() - 1;
+
+		// Pure math over the gathered arrays, no actor is touched
+		for (int32 i = 0; i < count; ++i)
+		{
+			if (enemyEngaged[i])
+			{
+				enemyBuckets[i] = 0;
+				continue;
+			}
+
+			const FVector toEnemy = enemyLocations[i] - cameraLocation;
+			const float distance = toEnemy.Size();
+			const bool bVisible = FVector::DotProduct(toEnemy, cameraForward) >= cosViewCone * distance;
+
+			int32 bucketIndex = 0;
+			for (; bucketIndex < lastBucket; ++bucketIndex)
+			{
+				const FEnemySignificanceBucket& bucket = buckets[bucketIndex];
+
+				if (bucket.maxDistance > 0.f && distance > bucket.maxDistance) continue;
+				if (bucket.bOnlyWhenVisible && !bVisible) continue;
+				break;
+			}
+
+			enemyBuckets[i] = bucketIndex;
+		}
+	}
+
+	bucketCounts.Init(0, buckets.Num());
+
+	for (int32 i = 0; i < count; ++i)
+	{
+		FEnemySignificance& entry = enemies[i];
+		++bucketCounts[enemyBuckets[i]];
+
+		if (entry.bucket == enemyBuckets[i]) continue;
+		ApplyBucket(entry, entry.enemy.Get(), enemyBuckets[i]);
+	}
+
+	SET_DWORD_STAT(STAT_SignificanceEnemiesFullRate, bucketCounts[0]);
+}
+
+void UEnemySignificanceSubsystem::ApplyBucket(FEnemySignificance& entry, AEnemy* enemy, int32 bucketIndex)
+{
+	if (!enemy || !buckets.IsValidIndex(bucketIndex) || entry.bucket == bucketIndex) return;
+
+	INC_DWORD_STAT(STAT_SignificanceBucketChanges);
+
+	entry.bucket = bucketIndex;
+	const FEnemySignificanceBucket& bucket = buckets[bucketIndex];
+
+	enemy->SetActorTickInterval(bucket.actorTickInterval);
+
+	if (UCharacterMovementComponent* movement = enemy->GetCharacterMovement())
+	{
+		movement->SetComponentTickInterval(bucket.movementTickInterval);
+	}
+
+	if (USkeletalMeshComponent* mesh = enemy->GetMesh())
+	{
+		mesh->SetComponentTickInterval(bucket.animTickInterval);
+		mesh->VisibilityBasedAnimTickOption = bucket.bOnlyTickMontagesWhenHidden
+			? EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered
+			: entry.defaultAnimTickOption;
+	}
+
+	const AEnemyController* enemyController = enemy->GetEnemyController();
+	UEnemyBehaviorTreeComponent* behaviorTreeComponent = enemyController ? enemyController->GetBehaviorTreeComponent() : NULL;
+
+	if (behaviorTreeComponent)
+	{
+		behaviorTreeComponent->SetThrottleInterval(bucket.behaviorTreeTickInterval);
+	}
+}
+
+void UEnemySignificanceSubsystem::RemoveAtSwap(int32 index)
+{
+	if (!enemies.IsValidIndex(index)) return;
+
+	const int32 lastIndex = enemies.Num() - 1;
+
+	enemyToIndex.Remove(enemies[index].enemyKey);
+
+	// Last enemy moves into the freed slot
+	if (index != lastIndex)
+	{
+		enemyToIndex.Add(enemies[lastIndex].enemyKey, index);
+	}
+
+	enemies.RemoveAtSwap(index, 1, false);
+}
+
+void UEnemySignificanceSubsystem::LogBucketCounts() const
+{
+	UE_LOG(LogTemp, Log, TEXT("Enemy significance %s, %d enemies"), IsSignificanceEnabled() ? TEXT("on") : TEXT("off"), enemies.Num());
+
+	for (int32 i = 0; i < bucketCounts.Num(); ++i)
+	{
+		const FEnemySignificanceBucket& bucket = buckets[i];
+
+		UE_LOG(LogTemp, Log, TEXT("  Bucket %d: %d enemies, tick %.3fs, movement %.3fs, anim %.3fs, behavior tree %.3fs"),
+			i, bucketCounts[i], bucket.actorTickInterval, bucket.movementTickInterval, bucket.animTickInterval, bucket.behaviorTreeTickInterval);
+	}
+}
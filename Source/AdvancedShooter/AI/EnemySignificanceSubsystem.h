@@ -0,0 +1,124 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "Components/SkinnedMeshComponent.h"
+#include "EnemySignificanceSubsystem.generated.h"
+
+class AEnemy;
+
+// How often an enemy in one significance bucket updates, intervals are in seconds and 0 is every frame
+USTRUCT()
+struct FEnemySignificanceBucket
+{
+	GENERATED_BODY()
+
+	// Furthest an enemy can be from the camera to land in this bucket, 0 for any distance
+	UPROPERTY(Config, EditAnywhere)
+	float maxDistance = 0.f;
+
+	// Only enemies in the cameras view cone land in this bucket
+	UPROPERTY(Config, EditAnywhere)
+	bool bOnlyWhenVisible = false;
+
+	UPROPERTY(Config, EditAnywhere)
+	float actorTickInterval = 0.f;
+
+	UPROPERTY(Config, EditAnywhere)
+	float movementTickInterval = 0.f;
+
+	UPROPERTY(Config, EditAnywhere)
+	float animTickInterval = 0.f;
+
+	UPROPERTY(Config, EditAnywhere)
+	float behaviorTreeTickInterval = 0.f;
+
+	// Off screen meshes only advance montages so attack notifies still fire
+	UPROPERTY(Config, EditAnywhere)
+	bool bOnlyTickMontagesWhenHidden = false;
+};
+
+// One registered enemy
+struct FEnemySignificance
+{
+	TWeakObjectPtr<AEnemy> enemy;
+
+	// Still valid once the enemy is destroyed, for removing it from the index
+	FObjectKey enemyKey;
+
+	// World time until which the enemy stays in the first bucket after a combat reaction
+	float wakeUntil = 0.f;
+
+	// Bucket whose settings are applied, none until the first update
+	int32 bucket = INDEX_NONE;
+
+	EVisibilityBasedAnimTickOption defaultAnimTickOption = EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
+};
+
+/*
+Scales how often each enemy thinks, moves, animates and ticks by how much it matters to the player.
+Once per frame every enemy is scored against the player camera in one pass over contiguous arrays and put
+in the first configured bucket it qualifies for, most significant first. Settings are only pushed to an
+enemy when its bucket changes. Combat reactions wake an enemy into the first bucket straight away.
+*/
+UCLASS(Config = Game)
+class ADVANCEDSHOOTER_API UEnemySignificanceSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void AddEnemy(AEnemy* enemy);
+	void RemoveEnemy(AEnemy* enemy);
+
+	// Puts the enemy in the first bucket now and keeps it there for wakeDuration seconds
+	void WakeEnemy(AEnemy* enemy);
+
+	// Wakes the enemy through its worlds subsystem, does nothing when there is none
+	static void Wake(AEnemy* enemy);
+
+	static bool IsSignificanceEnabled();
+
+	int32 GetNumEnemies() const { return enemies.Num(); }
+
+	void LogBucketCounts() const;
+
+protected:
+	virtual bool DoesSupportWorldType(EWorldType::Type worldType) const override;
+
+private:
+	void RemoveAtSwap(int32 index);
+
+	void ApplyBucket(FEnemySignificance& entry, AEnemy* enemy, int32 bucketIndex);
+
+	// Most significant first, the last one should take any enemy
+	UPROPERTY(Config, EditAnywhere)
+	TArray<FEnemySignificanceBucket> buckets;
+
+	// Seconds an enemy stays fully awake after agro, a hit or a stun
+	UPROPERTY(Config, EditAnywhere)
+	float wakeDuration = 5.f;
+
+	// Extra degrees on the cameras field of view so enemies at the screen edge count as visible
+	UPROPERTY(Config, EditAnywhere)
+	float viewConeMargin = 10.f;
+
+	TArray<FEnemySignificance> enemies;
+
+	// Enemy to its index in enemies
+	TMap<FObjectKey, int32> enemyToIndex;
+
+	// Filled each tick alongside enemies
+	TArray<FVector> enemyLocations;
+	TArray<bool> enemyEngaged;
+	TArray<int32> enemyBuckets;
+
+	// Enemies in each bucket after the last update
+	TArray<int32> bucketCounts;
+};
@@ -0,0 +1,362 @@
+#include "EnemySpawnerSubsystem.h"
+#include <AdvancedShooter/AdvancedShooter.h>
+#include <AdvancedShooter/Data/AssetStreamingSubsystem.h>
+#include <Kismet/GameplayStatics.h>
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Enemy Spawner Update"), STAT_EnemySpawnerUpdate, STATGROUP_AdvancedShooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Enemy Pool Hits"), STAT_EnemyPoolHits, STATGROUP_AdvancedShooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Enemy Pool Misses"), STAT_EnemyPoolMisses, STATGROUP_AdvancedShooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Enemy Pool Dormant"), STAT_EnemyPoolDormant, STATGROUP_AdvancedShooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Enemy Pool Active"), STAT_EnemyPoolActive, STATGROUP_AdvancedShooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Enemy Spawns Pending"), STAT_EnemySpawnsPending, STATGROUP_AdvancedShooter);
+
+static FAutoConsoleCommandWithWorld StartWavesCommand(
+	TEXT("Shooter.Waves.Start"),
+	TEXT("Starts the enemy waves from the first wave in the wave table."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* world)
+	{
+		UEnemySpawnerSubsystem* spawner = world ? world->GetSubsystem<UEnemySpawnerSubsystem>() : NULL;
+		if (!spawner) return;
+
+		spawner->StartWaves();
+	}));
+
+static FAutoConsoleCommandWithWorld StopWavesCommand(
+	TEXT("Shooter.Waves.Stop"),
+	TEXT("Stops the enemy waves and drops any spawns still queued."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* world)
+	{
+		UEnemySpawnerSubsystem* spawner = world ? world->GetSubsystem<UEnemySpawnerSubsystem>() : NULL;
+		if (!spawner) return;
+
+		spawner->StopWaves();
+	}));
+
+static FAutoConsoleCommandWithWorld DumpEnemyPoolsCommand(
+	TEXT("Shooter.EnemyPool.Dump"),
+	TEXT("Logs hits, misses and peak usage for every enemy pool in the world."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* world)
+	{
+		if (!world) return;
+
+		const UEnemySpawnerSubsystem* spawner = world->GetSubsystem<UEnemySpawnerSubsystem>();
+		if (!spawner) return;
+
+		spawner->LogPoolStats();
+	}));
+
+bool UEnemySpawnerSubsystem::DoesSupportWorldType(EWorldType::Type worldType) const
+{
+	return worldType == EWorldType::Game || worldType == EWorldType::PIE;
+}
+
+void UEnemySpawnerSubsystem::OnWorldBeginPlay(UWorld& world)
+{
+	Super::OnWorldBeginPlay(world);
+
+	if (bStartWavesOnBeginPlay) StartWaves();
+}
+
+void UEnemySpawnerSubsystem::Deinitialize()
+{
+	LogPoolStats();
+
+	// Dormant enemies are level actors and go with the world, only the bookkeeping needs clearing
+	pools.Empty();
+	activeEnemies.Empty();
+	pendingSpawns.Empty();
+	waveClasses.Empty();
+	spawnPoints.Empty();
+	spawnPointCursors.Empty();
+	waveEnemies.Empty();
+
+	SET_DWORD_STAT(STAT_EnemyPoolDormant, 0);
+	SET_DWORD_STAT(STAT_EnemyPoolActive, 0);
+	SET_DWORD_STAT(STAT_EnemySpawnsPending, 0);
+
+	Super::Deinitialize();
+}
+
+TStatId UEnemySpawnerSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UEnemySpawnerSubsystem, STATGROUP_Tickables);
+}
+
+void UEnemySpawnerSubsystem::StartWaves()
+{
+	StopWaves();
+
+	const UDataTable* table = waveTable.LoadSynchronous();
+	if (!table)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Enemy spawner has no wave table set"));
+		return;
+	}
+
+	TArray<FEnemyWaveDataTable*> rows;
+	table->GetAllRows(TEXT("EnemySpawner"), rows);
+
+	for (const FEnemyWaveDataTable* row : rows)
+	{
+		waveNumbers.AddUnique(row->wave);
+	}
+
+	if (waveNumbers.Num() == 0) return;
+	waveNumbers.Sort();
+
+	// Spawn points may have moved since the last run, eg in a new level
+	spawnPoints.Reset();
+	spawnPointCursors.Reset();
+
+	bWavesRunning = true;
+	waveIndex = 0;
+	QueueWave();
+}
+
+void UEnemySpawnerSubsystem::StopWaves()
+{
+	bWavesRunning = false;
+	waveIndex = INDEX_NONE;
+	nextWaveTime = 0.f;
+
+	waveNumbers.Reset();
+	pendingSpawns.Reset();
+	waveEnemies.Reset();
+}
+
+void UEnemySpawnerSubsystem::QueueWave()
+{
+	const UDataTable* table = waveTable.Get();
+	if (!table || !waveNumbers.IsValidIndex(waveIndex)) return;
+
+	const int32 wave = waveNumbers[waveIndex];
+	const float worldTime = GetWorld()->GetTimeSeconds();
+
+	TArray<FEnemyWaveDataTable*> rows;
+	table->GetAllRows(TEXT("EnemySpawner"), rows);
+
+	for (const FEnemyWaveDataTable* row : rows)
+	{
+		if (row->wave != wave || row->count <= 0) continue;
+
+		// Wave start is the place to take the hit of loading the class
+		UClass* enemyClass = row->enemyClass.LoadSynchronous();
+		const TArray<TWeakObjectPtr<AActor>>& points = GetSpawnPoints(row->spawnPointTag);
+
+		if (!enemyClass || points.Num() == 0)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Wave %d skips %d enemies, missing class or no actors tagged %s"), wave, row->count, *row->spawnPointTag.ToString());
+			continue;
+		}
+
+		waveClasses.AddUnique(enemyClass);
+
+		// Delayed groups stream in while the earlier ones fight
+		UAssetStreamingSubsystem::PrefetchRow(this, EGameDataTable::EGDT_Enemy, (uint8)row->enemyType);
+
+		// Groups sharing a tag carry on from the next point instead of all starting on the first
+		int32& pointCursor = spawnPointCursors.FindOrAdd(row->spawnPointTag);
+
+		for (int32 i = 0; i < row->count; ++i)
+		{
+			const AActor* point = points[pointCursor++ % points.Num()].Get();
+			if (!point) continue;
+
+			FEnemySpawnRequest& request = pendingSpawns.AddDefaulted_GetRef();
+			request.enemyClass = enemyClass;
+			request.enemyType = row->enemyType;
+			request.enemyLevel = row->enemyLevel;
+			request.transform = point->GetActorTransform();
+			request.spawnTime = worldTime + row->spawnDelay;
+		}
+	}
+
+	// Stable so enemies of one group keep their spawn point order
+	pendingSpawns.StableSort([](const FEnemySpawnRequest& a, const FEnemySpawnRequest& b)
+	{
+		return a.spawnTime > b.spawnTime;
+	});
+
+	nextWaveTime = 0.f;
+
+	UE_LOG(LogTemp, Log, TEXT("Wave %d started, %d enemies queued"), wave, pendingSpawns.Num());
+}
+
+const TArray<TWeakObjectPtr<AActor>>& UEnemySpawnerSubsystem::GetSpawnPoints(FName tag)
+{
+	if (const TArray<TWeakObjectPtr<AActor>>* points = spawnPoints.Find(tag)) return *points;
+
+	TArray<TWeakObjectPtr<AActor>>& points = spawnPoints.Add(tag);
+	if (tag.IsNone()) return points;
+
+	TArray<AActor*> taggedActors;
+	UGameplayStatics::GetAllActorsWithTag(this, tag, taggedActors);
+
+	points.Append(taggedActors);
+	return points;
+}
+
+void UEnemySpawnerSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_EnemySpawnerUpdate);
+
+	if (!bWavesRunning) return;
+
+	const float worldTime = GetWorld()->GetTimeSeconds();
+
+	// Next due spawn is at the end, the budget keeps a big wave from landing on one frame
+	int32 spawned = 0;
+	while (spawned < spawnsPerFrame && pendingSpawns.Num() > 0 && pendingSpawns.Last().spawnTime <= worldTime)
+	{
+		const FEnemySpawnRequest request = pendingSpawns.Pop(false);
+		++spawned;
+
+		AEnemy* enemy = SpawnEnemy(request.enemyClass, request.enemyType, request.enemyLevel, request.transform);
+		if (enemy) waveEnemies.Add(enemy);
+	}
+
+	SET_DWORD_STAT(STAT_EnemySpawnsPending, pendingSpawns.Num());
+
+	// Anything destroyed without going through the pool, eg by a kill volume
+	waveEnemies.RemoveAllSwap([](const TWeakObjectPtr<AEnemy>& enemy) { return !enemy.IsValid(); }, false);
+
+	if (pendingSpawns.Num() > 0 || waveEnemies.Num() > 0) return;
+
+	if (nextWaveTime <= 0.f)
+	{
+		UE_LOG(LogTemp, Log, TEXT("Wave %d cleared"), waveNumbers[waveIndex]);
+
+		if (waveIndex + 1 >= waveNumbers.Num())
+		{
+			StopWaves();
+			return;
+		}
+
+		nextWaveTime = worldTime + timeBetweenWaves;
+		return;
+	}
+
+	if (worldTime < nextWaveTime) return;
+
+	++waveIndex;
+	QueueWave();
+}
+
+AEnemy* UEnemySpawnerSubsystem::SpawnEnemy(TSubclassOf<AEnemy> enemyClass, EEnemyType enemyType, EEnemyLevel enemyLevel, const FTransform& transform)
+{
+	UWorld* world = GetWorld();
+	if (!enemyClass || !world) return NULL;
+
+	FEnemyPoolKey key;
+	key.enemyClass = enemyClass;
+	key.enemyType = enemyType;
+
+	FEnemyPool& pool = pools.FindOrAdd(key);
+
+	AEnemy* enemy = NULL;
+
+	// Anything destroyed while dormant, eg by a level script, is skipped
+	while (!enemy && pool.freeEnemies.Num() > 0)
+	{
+		enemy = pool.freeEnemies.Pop(false);
+		DEC_DWORD_STAT(STAT_EnemyPoolDormant);
+
+		if (!IsValid(enemy)) enemy = NULL;
+	}
+
+	if (enemy)
+	{
+		INC_DWORD_STAT(STAT_EnemyPoolHits);
+		++pool.stats.hits;
+
+		enemy->ResetFromPool(transform, enemyLevel);
+	}
+
+	else
+	{
+		INC_DWORD_STAT(STAT_EnemyPoolMisses);
+		++pool.stats.misses;
+
+		enemy = world->SpawnActorDeferred<AEnemy>(enemyClass, transform, NULL, NULL, ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn);
+		if (!enemy) return NULL;
+
+		// Construction reads the rows, so they have to be set first
+		enemy->SetEnemyRows(enemyType, enemyLevel);
+		enemy->FinishSpawning(transform);
+	}
+
+	activeEnemies.Add(FObjectKey(enemy), key);
+	INC_DWORD_STAT(STAT_EnemyPoolActive);
+
+	++pool.activeCount;
+	pool.stats.peakActive = FMath::Max(pool.stats.peakActive, pool.activeCount);
+
+	return enemy;
+}
+
+void UEnemySpawnerSubsystem::ReleaseEnemy(AEnemy* enemy)
+{
+	if (!enemy) return;
+
+	waveEnemies.RemoveSwap(enemy, false);
+
+	FEnemyPoolKey key;
+
+	// Not ours, eg placed in the level
+	if (!activeEnemies.RemoveAndCopyValue(FObjectKey(enemy), key))
+	{
+		enemy->Destroy();
+		return;
+	}
+
+	DEC_DWORD_STAT(STAT_EnemyPoolActive);
+
+	FEnemyPool& pool = pools.FindOrAdd(key);
+	pool.activeCount = FMath::Max(pool.activeCount - 1, 0);
+	++pool.stats.releases;
+
+	if (pool.freeEnemies.Num() >= maxPoolSize)
+	{
+		++pool.stats.overflows;
+
+		// The controller was spawned for this enemy and would be left behind
+		if (AController* controller = enemy->GetController()) controller->Destroy();
+		enemy->Destroy();
+		return;
+	}
+
+	enemy->ReturnToPool();
+
+	pool.freeEnemies.Add(enemy);
+	INC_DWORD_STAT(STAT_EnemyPoolDormant);
+}
+
+void UEnemySpawnerSubsystem::ReleasePooledEnemy(AEnemy* enemy)
+{
+	if (!enemy) return;
+
+	UEnemySpawnerSubsystem* spawner = enemy->GetWorld() ? enemy->GetWorld()->GetSubsystem<UEnemySpawnerSubsystem>() : NULL;
+
+	if (!spawner)
+	{
+		enemy->Destroy();
+		return;
+	}
+
+	spawner->ReleaseEnemy(enemy);
+}
+
+void UEnemySpawnerSubsystem::LogPoolStats() const
+{
+	for (const TPair<FEnemyPoolKey, FEnemyPool>& poolPair : pools)
+	{
+		const FEnemyPoolStats& stats = poolPair.Value.stats;
+
+		UE_LOG(LogTemp, Log, TEXT("Enemy pool %s %s: dormant %d, active %d, hits %d, misses %d, releases %d (destroyed %d), peak %d"),
+			*GetNameSafe(poolPair.Key.enemyClass), *UEnum::GetValueAsString(poolPair.Key.enemyType),
+			poolPair.Value.freeEnemies.Num(), poolPair.Value.activeCount,
+			stats.hits, stats.misses, stats.releases, stats.overflows, stats.peakActive);
+	}
+}
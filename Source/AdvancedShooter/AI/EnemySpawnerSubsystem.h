@@ -0,0 +1,205 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include <Engine/DataTable.h>
+#include <AdvancedShooter/AI/Enemy.h>
+#include "EnemySpawnerSubsystem.generated.h"
+
+// One group of enemies in a wave, every row with the same wave number spawns together
+USTRUCT(BlueprintType)
+struct FEnemyWaveDataTable : public FTableRowBase
+{
+	GENERATED_BODY()
+
+	// Waves run in ascending order, the next one starts once every enemy of the last is dead
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 wave = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TSoftClassPtr<AEnemy> enemyClass;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	EEnemyType enemyType = EEnemyType::EET_Grux;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	EEnemyLevel enemyLevel = EEnemyLevel::EEL_Level1;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 count = 1;
+
+	// Enemies are spread over the level actors with this tag
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FName spawnPointTag;
+
+	// Seconds after the wave starts before this group spawns
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float spawnDelay = 0.f;
+};
+
+// Enemies are only interchangeable when they share a class and an enemy type, the level is reapplied on reuse
+USTRUCT()
+struct FEnemyPoolKey
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	UClass* enemyClass = NULL;
+
+	UPROPERTY()
+	EEnemyType enemyType = EEnemyType::EET_Grux;
+
+	bool operator==(const FEnemyPoolKey& other) const { return enemyClass == other.enemyClass && enemyType == other.enemyType; }
+
+	friend uint32 GetTypeHash(const FEnemyPoolKey& key) { return HashCombine(GetTypeHash(key.enemyClass), GetTypeHash(key.enemyType)); }
+};
+
+USTRUCT(BlueprintType)
+struct FEnemyPoolStats
+{
+	GENERATED_BODY()
+
+	// Spawns served by a dormant enemy
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 hits = 0;
+
+	// Spawns that had to create an enemy and its controller
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 misses = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 releases = 0;
+
+	// Releases destroyed because the pool was full
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 overflows = 0;
+
+	// Most enemies out of the pool at once
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 peakActive = 0;
+};
+
+USTRUCT()
+struct FEnemyPool
+{
+	GENERATED_BODY()
+
+	// Dormant enemies ready to be spawned again
+	UPROPERTY()
+	TArray<AEnemy*> freeEnemies;
+
+	int32 activeCount = 0;
+
+	FEnemyPoolStats stats;
+};
+
+// An enemy waiting for its turn in the spawn budget
+struct FEnemySpawnRequest
+{
+	UClass* enemyClass = NULL;
+	EEnemyType enemyType = EEnemyType::EET_Grux;
+	EEnemyLevel enemyLevel = EEnemyLevel::EEL_Level1;
+	FTransform transform;
+
+	// World time it may spawn from
+	float spawnTime = 0.f;
+};
+
+/*
+Runs horde waves from the wave data table and keeps dead enemies, along with the controller possessing them,
+dormant for the next spawn instead of destroying them. Wave spawns are queued and at most spawnsPerFrame
+come out each frame, so a large wave is spread over several frames instead of landing on one.
+Settings are in the [/Script/AdvancedShooter.EnemySpawnerSubsystem] section of DefaultGame.ini.
+*/
+UCLASS(Config = Game)
+class ADVANCEDSHOOTER_API UEnemySpawnerSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void OnWorldBeginPlay(UWorld& world) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Starts from the first wave in the table
+	void StartWaves();
+	void StopWaves();
+
+	bool AreWavesRunning() const { return bWavesRunning; }
+
+	// Spawns now, reusing a dormant enemy of the class and type when there is one
+	AEnemy* SpawnEnemy(TSubclassOf<AEnemy> enemyClass, EEnemyType enemyType, EEnemyLevel enemyLevel, const FTransform& transform);
+
+	// Returns an enemy from SpawnEnemy to its pool, anything else is destroyed
+	void ReleaseEnemy(AEnemy* enemy);
+
+	// Goes through the worlds spawner, destroying the enemy when there is none
+	static void ReleasePooledEnemy(AEnemy* enemy);
+
+	// Writes the stats for every pool to the log
+	void LogPoolStats() const;
+
+protected:
+	virtual bool DoesSupportWorldType(EWorldType::Type worldType) const override;
+
+private:
+	// Queues every group of the wave at the current position in waveNumbers
+	void QueueWave();
+
+	// Level actors with the tag, looked up once per tag
+	const TArray<TWeakObjectPtr<AActor>>& GetSpawnPoints(FName tag);
+
+	UPROPERTY()
+	TMap<FEnemyPoolKey, FEnemyPool> pools;
+
+	// Enemies out of their pool, for finding the pool on release
+	TMap<FObjectKey, FEnemyPoolKey> activeEnemies;
+
+	// Latest spawn time first so the next one due is popped off the end
+	TArray<FEnemySpawnRequest> pendingSpawns;
+
+	// Enemy classes loaded from the wave table, kept loaded while spawns reference them
+	UPROPERTY()
+	TArray<UClass*> waveClasses;
+
+	TMap<FName, TArray<TWeakObjectPtr<AActor>>> spawnPoints;
+
+	// Next spawn point to use for each tag
+	TMap<FName, int32> spawnPointCursors;
+
+	// Wave numbers in the table, ascending
+	TArray<int32> waveNumbers;
+
+	int32 waveIndex = INDEX_NONE;
+
+	// Enemies of the current wave still alive
+	TArray<TWeakObjectPtr<AEnemy>> waveEnemies;
+
+	// World time the next wave starts, once the current one is cleared
+	float nextWaveTime = 0.f;
+
+	bool bWavesRunning = false;
+
+	UPROPERTY(Config)
+	TSoftObjectPtr<UDataTable> waveTable;
+
+	// Starts the waves when the level begins play
+	UPROPERTY(Config)
+	bool bStartWavesOnBeginPlay = false;
+
+	// Most enemies spawned or reused in one frame
+	UPROPERTY(Config)
+	int32 spawnsPerFrame = 2;
+
+	// Seconds between clearing a wave and the next one starting
+	UPROPERTY(Config)
+	float timeBetweenWaves = 5.f;
+
+	// Released enemies past this many in one pool are destroyed instead
+	UPROPERTY(Config)
+	int32 maxPoolSize = 32;
+};
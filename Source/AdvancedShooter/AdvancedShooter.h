@@ -3,4 +3,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Stats/Stats.h"
 
+// Stat group for the game's own systems, view with "stat AdvancedShooter"
+DECLARE_STATS_GROUP(TEXT("AdvancedShooter"), STATGROUP_AdvancedShooter, STATCAT_Advanced);
@@ -0,0 +1,136 @@
+#include "CrosshairQueryCache.h"
+#include <AdvancedShooter/AdvancedShooter.h>
+#include <AdvancedShooter/ShooterCharacter.h>
+#include <Kismet/GameplayStatics.h>
+#include <Camera/PlayerCameraManager.h>
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Crosshair Queries"), STAT_CrosshairQueries, STATGROUP_AdvancedShooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Crosshair Deprojections"), STAT_CrosshairDeprojections, STATGROUP_AdvancedShooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Crosshair Traces Run"), STAT_CrosshairTracesRun, STATGROUP_AdvancedShooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Crosshair Traces Saved"), STAT_CrosshairTracesSaved, STATGROUP_AdvancedShooter);
+
+bool FCrosshairQueryCache::GetRay(const AShooterCharacter* character, FVector& outStart, FVector& outDirection)
+{
+	if (!UpdateRay(character)) return false;
+
+	outStart = rayStart;
+	outDirection = rayDirection;
+	return true;
+}
+
+APlayerController* FCrosshairQueryCache::GetView(const AShooterCharacter* character, FVector& outLocation, FRotator& outRotation)
+{
+	APlayerController* playerController = character ? UGameplayStatics::GetPlayerController(character, 0) : NULL;
+	if (!playerController) return NULL;
+
+	const APlayerCameraManager* cameraManager = playerController->PlayerCameraManager;
+	outLocation = cameraManager ? cameraManager->GetCameraLocation() : FVector::ZeroVector;
+	outRotation = cameraManager ? cameraManager->GetCameraRotation() : FRotator::ZeroRotator;
+
+	return playerController;
+}
+
+bool FCrosshairQueryCache::UpdateRay(const AShooterCharacter* character)
+{
+	INC_DWORD_STAT(STAT_CrosshairQueries);
+
+	FVector cameraLocation;
+	FRotator cameraRotation;
+
+	APlayerController* playerController = GetView(character, cameraLocation, cameraRotation);
+	if (!playerController) return false;
+
+	// Same frame and same view, the cached ray is still good
+	if (rayFrame == GFrameCounter && cameraLocation == viewLocation && cameraRotation == viewRotation)
+		return bRayValid;
+
+	INC_DWORD_STAT(STAT_CrosshairDeprojections);
+
+	rayFrame = GFrameCounter;
+	viewLocation = cameraLocation;
+	viewRotation = cameraRotation;
+
+	// Ray changed so the trace along it has to be run again
+	traceFrame = MAX_uint64;
+
+	// Get screen space location of crosshairs
+	FVector2D viewportSize;
+	if (GEngine && GEngine->GameViewport)
+	{
+		GEngine->GameViewport->GetViewportSize(viewportSize);
+	}
+	const FVector2D crossHairLocation = FVector2D(viewportSize.X / 2.f, viewportSize.Y / 2.f);
+
+	// Get world position and direction of crosshairs
+	bRayValid = UGameplayStatics::DeprojectScreenToWorld(playerController, crossHairLocation, rayStart, rayDirection);
+
+	return bRayValid;
+}
+
+bool FCrosshairQueryCache::CoversRange(float range) const
+{
+	if (traceFrame != rayFrame) return false;
+
+	// A hit inside the traced range is also the first hit of any longer trace
+	return range <= tracedRange || (traceHitResult.bBlockingHit && traceHitResult.Distance <= range);
+}
+
+bool FCrosshairQueryCache::HasTrace(const AShooterCharacter* character, float range) const
+{
+	if (rayFrame != GFrameCounter) return false;
+
+	FVector cameraLocation;
+	FRotator cameraRotation;
+	if (!GetView(character, cameraLocation, cameraRotation)) return false;
+
+	return cameraLocation == viewLocation && cameraRotation == viewRotation && CoversRange(range);
+}
+
+bool FCrosshairQueryCache::Trace(const AShooterCharacter* character, float range, FHitResult& outHitResult, FVector& outHitLocation)
+{
+	if (!UpdateRay(character)) return false;
+
+	if (CoversRange(range))
+	{
+		INC_DWORD_STAT(STAT_CrosshairTracesSaved);
+	}
+
+	else if (traceFrame == rayFrame)
+	{
+		INC_DWORD_STAT(STAT_CrosshairTracesRun);
+
+		// Only the part of the ray past the cached trace is new, which had no hit
+		const FVector start = rayStart + rayDirection * tracedRange;
+		const FVector end = rayStart + rayDirection * range;
+		character->GetWorld()->LineTraceSingleByChannel(traceHitResult, start, end, ECollisionChannel::ECC_Visibility);
+
+		// Distances stay measured from the ray start like a single trace
+		if (traceHitResult.bBlockingHit) traceHitResult.Distance += tracedRange;
+		traceHitResult.TraceStart = rayStart;
+		tracedRange = range;
+	}
+
+	else
+	{
+		INC_DWORD_STAT(STAT_CrosshairTracesRun);
+
+		tracedRange = range;
+		traceFrame = rayFrame;
+
+		const FVector end = rayStart + rayDirection * tracedRange;
+		character->GetWorld()->LineTraceSingleByChannel(traceHitResult, rayStart, end, ECollisionChannel::ECC_Visibility);
+	}
+
+	// Clip the shared trace to the callers range
+	outHitLocation = rayStart + rayDirection * range;
+
+	if (traceHitResult.bBlockingHit && traceHitResult.Distance <= range)
+	{
+		outHitResult = traceHitResult;
+		outHitLocation = traceHitResult.Location;
+		return true;
+	}
+
+	outHitResult = FHitResult(rayStart, outHitLocation);
+	return false;
+}
@@ -0,0 +1,52 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AShooterCharacter;
+
+/*
+Deprojects the crosshair and traces along it at most once per frame and camera.
+The trace runs at the range first asked for, usually the short item range. A longer query reuses
+a hit already found and otherwise only traces the part of the ray past the cached range.
+*/
+class ADVANCEDSHOOTER_API FCrosshairQueryCache
+{
+public:
+	// World space ray through the centre of the screen
+	bool GetRay(const AShooterCharacter* character, FVector& outStart, FVector& outDirection);
+
+	// Crosshair trace clipped to range, true when something blocking is inside range
+	bool Trace(const AShooterCharacter* character, float range, FHitResult& outHitResult, FVector& outHitLocation);
+
+	// True when a Trace to range would be answered from this frames cache without tracing
+	bool HasTrace(const AShooterCharacter* character, float range) const;
+
+private:
+	// Player controller and camera the ray is deprojected from
+	static APlayerController* GetView(const AShooterCharacter* character, FVector& outLocation, FRotator& outRotation);
+
+	// Deprojects again if the frame or the camera changed since the last call
+	bool UpdateRay(const AShooterCharacter* character);
+
+	// True when the cached trace answers a query to range
+	bool CoversRange(float range) const;
+
+	// Length the cached trace was actually run at
+	float tracedRange = 0.f;
+
+	// Frame the ray and trace were cached on
+	uint64 rayFrame = MAX_uint64;
+	uint64 traceFrame = MAX_uint64;
+
+	// Camera the ray was deprojected from
+	FVector viewLocation = FVector::ZeroVector;
+	FRotator viewRotation = FRotator::ZeroRotator;
+
+	FVector rayStart = FVector::ZeroVector;
+	FVector rayDirection = FVector::ForwardVector;
+	bool bRayValid = false;
+
+	FHitResult traceHitResult;
+};
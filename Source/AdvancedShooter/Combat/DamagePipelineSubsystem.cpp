@@ -0,0 +1,184 @@
+#include "DamagePipelineSubsystem.h"
+#include <AdvancedShooter/AdvancedShooter.h>
+#include <AdvancedShooter/AI/Enemy.h>
+#include <AdvancedShooter/Effects/DamageNumberComponent.h>
+#include <Kismet/GameplayStatics.h>
+#include <GameFramework/DamageType.h>
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Damage Flush"), STAT_DamageFlush, STATGROUP_AdvancedShooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damage Events Queued"), STAT_DamageEventsQueued, STATGROUP_AdvancedShooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damage Targets Resolved"), STAT_DamageTargetsResolved, STATGROUP_AdvancedShooter);
+
+static TAutoConsoleVariable<int32> CVarDamageBatch(
+	TEXT("Shooter.Damage.Batch"),
+	1,
+	TEXT("0: apply damage the moment it is dealt.\n")
+	TEXT("1: queue damage and apply it once per target at the end of the frame."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarDamageDeterministic(
+	TEXT("Shooter.Damage.Deterministic"),
+	0,
+	TEXT("0: resolve targets in the order they were first hit.\n")
+	TEXT("1: resolve targets sorted by name so the order does not depend on trace completion order."),
+	ECVF_Default);
+
+void UDamagePipelineSubsystem::Initialize(FSubsystemCollectionBase& collection)
+{
+	Super::Initialize(collection);
+
+	postActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UDamagePipelineSubsystem::OnWorldPostActorTick);
+}
+
+void UDamagePipelineSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(postActorTickHandle);
+
+	queuedDamage.Empty();
+	resolvingDamage.Empty();
+	targetBatches.Empty();
+	targetBatchIndices.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UDamagePipelineSubsystem::DoesSupportWorldType(EWorldType::Type worldType) const
+{
+	return worldType == EWorldType::Game || worldType == EWorldType::PIE;
+}
+
+bool UDamagePipelineSubsystem::IsBatchingEnabled()
+{
+	return CVarDamageBatch.GetValueOnGameThread() != 0;
+}
+
+void UDamagePipelineSubsystem::QueueDamage(const UObject* worldContext, const FQueuedDamage& damage)
+{
+	UWorld* world = worldContext ? worldContext->GetWorld() : NULL;
+	UDamagePipelineSubsystem* damagePipeline = world ? world->GetSubsystem<UDamagePipelineSubsystem>() : NULL;
+
+	if (damagePipeline && IsBatchingEnabled())
+	{
+		damagePipeline->AddDamage(damage);
+		return;
+	}
+
+	// Legacy path, a batch of one applied right now
+	FDamageTargetBatch batch;
+	batch.target = damage.target.Get();
+	batch.instigator = damage.instigator.Get();
+	batch.causer = damage.causer.Get();
+	batch.amount = damage.amount;
+	batch.hitCount = 1;
+	batch.numberLocation = damage.hitLocation;
+	batch.bShowDamageNumber = damage.bShowDamageNumber;
+	batch.bIsHeadShot = damage.bIsHeadShot;
+
+	ApplyBatch(batch);
+}
+
+void UDamagePipelineSubsystem::AddDamage(const FQueuedDamage& damage)
+{
+	if (!damage.target.IsValid()) return;
+
+	INC_DWORD_STAT(STAT_DamageEventsQueued);
+
+	FQueuedDamage& queued = queuedDamage.Add_GetRef(damage);
+	queued.sequence = nextSequence++;
+}
+
+void UDamagePipelineSubsystem::OnWorldPostActorTick(UWorld* world, ELevelTick tickType, float deltaTime)
+{
+	if (world != GetWorld()) return;
+
+	FlushDamage();
+}
+
+void UDamagePipelineSubsystem::FlushDamage()
+{
+	if (queuedDamage.Num() == 0) return;
+
+	SCOPE_CYCLE_COUNTER(STAT_DamageFlush);
+
+	// Deaths and stuns can queue more damage (explosives, melee), that goes in the next flush
+	Swap(queuedDamage, resolvingDamage);
+	queuedDamage.Reset();
+
+	BuildTargetBatches();
+
+	for (const FDamageTargetBatch& batch : targetBatches)
+	{
+		ApplyBatch(batch);
+	}
+
+	INC_DWORD_STAT_BY(STAT_DamageTargetsResolved, targetBatches.Num());
+
+	resolvingDamage.Reset();
+	targetBatches.Reset();
+	targetBatchIndices.Reset();
+}
+
+void UDamagePipelineSubsystem::BuildTargetBatches()
+{
+	if (CVarDamageDeterministic.GetValueOnGameThread() != 0)
+	{
+		// Stable sort keeps the queue order for hits on the same target
+		resolvingDamage.StableSort([](const FQueuedDamage& a, const FQueuedDamage& b)
+		{
+			const AActor* targetA = a.target.Get();
+			const AActor* targetB = b.target.Get();
+
+			if (!targetA || !targetB) return targetA != NULL && targetB == NULL;
+			return targetA->GetFName().LexicalLess(targetB->GetFName());
+		});
+	}
+
+	for (const FQueuedDamage& damage : resolvingDamage)
+	{
+		AActor* target = damage.target.Get();
+		if (!target) continue;
+
+		int32* batchIndex = targetBatchIndices.Find(target);
+		FDamageTargetBatch& batch = batchIndex ? targetBatches[*batchIndex] : targetBatches.AddDefaulted_GetRef();
+
+		if (!batchIndex)
+		{
+			targetBatchIndices.Add(target, targetBatches.Num() - 1);
+			batch.target = target;
+		}
+
+		batch.amount += damage.amount;
+		++batch.hitCount;
+
+		// Latest hit decides who gets the credit
+		if (damage.instigator.IsValid()) batch.instigator = damage.instigator.Get();
+		if (damage.causer.IsValid()) batch.causer = damage.causer.Get();
+
+		if (!damage.bShowDamageNumber) continue;
+
+		batch.bShowDamageNumber = true;
+		batch.bIsHeadShot |= damage.bIsHeadShot;
+
+		if (damage.amount >= batch.largestHit)
+		{
+			batch.largestHit = damage.amount;
+			batch.numberLocation = damage.hitLocation;
+		}
+	}
+}
+
+void UDamagePipelineSubsystem::ApplyBatch(const FDamageTargetBatch& batch)
+{
+	// Target may have been destroyed by a batch resolved before it
+	if (!IsValid(batch.target)) return;
+
+	UGameplayStatics::ApplyDamage(batch.target, batch.amount, batch.instigator, batch.causer, UDamageType::StaticClass());
+
+	if (!batch.bShowDamageNumber) return;
+
+	if (!batch.target->IsA<AEnemy>()) return;
+
+	// One number with the frames total instead of one per bullet
+	UDamageNumberComponent::ShowDamageNumber(this, batch.instigator, batch.amount, batch.numberLocation, batch.bIsHeadShot);
+}
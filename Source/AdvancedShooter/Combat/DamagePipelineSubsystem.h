@@ -0,0 +1,97 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "DamagePipelineSubsystem.generated.h"
+
+// One hit waiting to be applied at the end of the frame
+struct FQueuedDamage
+{
+	TWeakObjectPtr<AActor> target;
+	TWeakObjectPtr<AController> instigator;
+	TWeakObjectPtr<AActor> causer;
+
+	float amount = 0.f;
+
+	// Where the hit landed, used for the damage number
+	FVector hitLocation = FVector::ZeroVector;
+
+	// True when the hit should show up as a damage number on enemies
+	bool bShowDamageNumber = false;
+	bool bIsHeadShot = false;
+
+	// Order the damage was queued in, keeps ordering stable when sorting
+	uint32 sequence = 0;
+};
+
+// Everything one target took this frame, applied as a single hit
+struct FDamageTargetBatch
+{
+	AActor* target = NULL;
+	AController* instigator = NULL;
+	AActor* causer = NULL;
+
+	float amount = 0.f;
+	int32 hitCount = 0;
+
+	// Damage number goes at the biggest hit
+	FVector numberLocation = FVector::ZeroVector;
+	float largestHit = 0.f;
+
+	bool bShowDamageNumber = false;
+	bool bIsHeadShot = false;
+};
+
+/*
+Queues bullet, melee and explosion damage during the frame and applies it once per target after actors have ticked.
+A target hit many times in one frame runs TakeDamage once, so the health bar, hit react, stun roll and damage number only happen once.
+Toggle with Shooter.Damage.Batch, Shooter.Damage.Deterministic resolves targets in name order so replays and tests line up.
+*/
+UCLASS()
+class ADVANCEDSHOOTER_API UDamagePipelineSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& collection) override;
+	virtual void Deinitialize() override;
+
+	// Queues through the worlds pipeline, applies the damage straight away when batching is off or there is no pipeline
+	static void QueueDamage(const UObject* worldContext, const FQueuedDamage& damage);
+
+	// Adds damage to this frames batch
+	void AddDamage(const FQueuedDamage& damage);
+
+	// Applies everything queued so far, normally called once at the end of the frame
+	void FlushDamage();
+
+	// True when Shooter.Damage.Batch is set
+	static bool IsBatchingEnabled();
+
+protected:
+	virtual bool DoesSupportWorldType(EWorldType::Type worldType) const override;
+
+private:
+	void OnWorldPostActorTick(UWorld* world, ELevelTick tickType, float deltaTime);
+
+	// Sums the queued hits per target into targetBatches
+	void BuildTargetBatches();
+
+	// Runs ApplyDamage and the damage number for one target
+	static void ApplyBatch(const FDamageTargetBatch& batch);
+
+	// Damage queued this frame
+	TArray<FQueuedDamage> queuedDamage;
+
+	// Damage being resolved, swapped with queuedDamage so anything queued while resolving waits for the next flush
+	TArray<FQueuedDamage> resolvingDamage;
+
+	TArray<FDamageTargetBatch> targetBatches;
+	TMap<AActor*, int32> targetBatchIndices;
+
+	FDelegateHandle postActorTickHandle;
+
+	uint32 nextSequence = 0;
+};
@@ -0,0 +1,79 @@
+#include "FireScheduler.h"
+#include <AdvancedShooter/AdvancedShooter.h>
+#include <AdvancedShooter/Items/Weapon.h>
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Scheduled Shots"), STAT_ScheduledShots, STATGROUP_AdvancedShooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Carried Over Shots"), STAT_CarriedOverShots, STATGROUP_AdvancedShooter);
+
+void FFireScheduler::Start(const AWeapon* weapon, float worldTime, const FTransform& muzzleTransform)
+{
+	if (!weapon) return;
+
+	firingWeapon = weapon;
+
+	// Guard against a zero fire rate in the data table spinning the loop in Advance
+	fireInterval = FMath::Max(weapon->GetFireRate(), 0.001f);
+	nextShotTime = worldTime + fireInterval;
+	lastAdvanceTime = worldTime;
+	previousMuzzleTransform = muzzleTransform;
+	bFiring = true;
+}
+
+void FFireScheduler::Stop()
+{
+	firingWeapon.Reset();
+	nextShotTime = 0.f;
+	bFiring = false;
+}
+
+bool FFireScheduler::Advance(const AWeapon* weapon, float worldTime, const FTransform& muzzleTransform,
+	bool bKeepFiring, int32 availableShots, TArray<FScheduledShot>& outShots)
+{
+	if (!bFiring) return false;
+
+	if (!weapon || firingWeapon.Get() != weapon)
+	{
+		Stop();
+		return false;
+	}
+
+	// The press counts as the start of the first frame, so the tick it happened on fires nothing more
+	const float frameStartTime = lastAdvanceTime;
+	const float frameTime = worldTime - frameStartTime;
+	int32 shotsThisTick = 0;
+
+	while (nextShotTime <= worldTime)
+	{
+		// Next shot is due but the trigger was let go or the mag is empty
+		if (!bKeepFiring || availableShots <= 0)
+		{
+			Stop();
+			break;
+		}
+
+		if (shotsThisTick >= maxShotsPerTick)
+		{
+			INC_DWORD_STAT(STAT_CarriedOverShots);
+			break;
+		}
+
+		// How far into this frame the shot was due, owed shots from a capped tick land at the start
+		const float shotOffset = FMath::Max(nextShotTime - frameStartTime, 0.f);
+		const float frameAlpha = frameTime > 0.f ? FMath::Clamp(shotOffset / frameTime, 0.f, 1.f) : 1.f;
+
+		FScheduledShot& shot = outShots.AddDefaulted_GetRef();
+		shot.fireTime = frameStartTime + shotOffset;
+		shot.muzzleTransform.Blend(previousMuzzleTransform, muzzleTransform, frameAlpha);
+
+		INC_DWORD_STAT(STAT_ScheduledShots);
+
+		nextShotTime += fireInterval;
+		--availableShots;
+		++shotsThisTick;
+	}
+
+	previousMuzzleTransform = muzzleTransform;
+	lastAdvanceTime = worldTime;
+
+	return bFiring;
+}
@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AWeapon;
+
+// A shot that became due during a tick
+struct FScheduledShot
+{
+	// World time the shot was due, can fall anywhere inside the frame
+	float fireTime = 0.f;
+
+	// Muzzle transform interpolated between last tick and this one at fireTime
+	FTransform muzzleTransform;
+};
+
+/*
+Keeps the world time of the next shot for the equipped weapon and works out how many shots fall inside each tick.
+The schedule is anchored to the press, so shots keep their exact time inside the frame, fire rate no longer
+snaps to frame time and weapons faster than the frame rate fire several rounds per tick instead of one.
+*/
+class ADVANCEDSHOOTER_API FFireScheduler
+{
+public:
+	// Starts a fire cycle for the weapon, the first shot is fired by the caller straight away
+	void Start(const AWeapon* weapon, float worldTime, const FTransform& muzzleTransform);
+
+	// Ends the fire cycle without waiting for the next shot
+	void Stop();
+
+	/*
+	Adds every shot due since the last advance up to worldTime to outShots.
+	When a shot is due but bKeepFiring is false or availableShots ran out, the fire cycle ends.
+	Returns true while the cycle is still running.
+	*/
+	bool Advance(const AWeapon* weapon, float worldTime, const FTransform& muzzleTransform,
+		bool bKeepFiring, int32 availableShots, TArray<FScheduledShot>& outShots);
+
+	bool IsFiring() const { return bFiring; }
+
+	// Upper limit on shots emitted in one tick, the rest carry over so a hitch doesnt lose rounds
+	void SetMaxShotsPerTick(int32 maxShots) { maxShotsPerTick = FMath::Max(1, maxShots); }
+
+private:
+	// Weapon the accumulator belongs to, swapping weapons ends the cycle
+	TWeakObjectPtr<const AWeapon> firingWeapon;
+
+	// World time the next shot is due, in the past when shots are owed
+	float nextShotTime = 0.f;
+
+	// World time of the last advance or the press, start of the current frame
+	float lastAdvanceTime = 0.f;
+
+	// Seconds between shots for the firing weapon
+	float fireInterval = 0.f;
+
+	// Muzzle at the end of the last tick, start of the interpolation
+	FTransform previousMuzzleTransform;
+
+	int32 maxShotsPerTick = 32;
+
+	bool bFiring = false;
+};
@@ -0,0 +1,77 @@
+#include "HitZoneTable.h"
+#include <AdvancedShooter/AdvancedShooter.h>
+#include <Components/SkeletalMeshComponent.h>
+#include <PhysicsEngine/BodyInstance.h>
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hit Zone Lookups"), STAT_HitZoneLookups, STATGROUP_AdvancedShooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hit Zone Bone Name Fallbacks"), STAT_HitZoneNameFallbacks, STATGROUP_AdvancedShooter);
+
+void FHitZoneTable::Build(const USkeletalMeshComponent* mesh, FName headBoneName, const TArray<FName>& limbBoneNames)
+{
+	boneZones.Reset();
+	bodyZones.Reset();
+	meshComponent = mesh;
+
+	if (!mesh || !mesh->GetSkeletalMeshAsset()) return;
+
+	const FReferenceSkeleton& refSkeleton = mesh->GetSkeletalMeshAsset()->GetRefSkeleton();
+	const int32 boneCount = refSkeleton.GetNum();
+
+	boneZones.Init(EHitZone::Torso, boneCount);
+
+	// Parents always come before their children in the reference skeleton, so one pass fills the hierarchy
+	for (int32 boneIndex = 0; boneIndex < boneCount; ++boneIndex)
+	{
+		const FName boneName = refSkeleton.GetBoneName(boneIndex);
+
+		if (boneName == headBoneName)
+		{
+			boneZones[boneIndex] = EHitZone::Head;
+		}
+
+		else if (limbBoneNames.Contains(boneName))
+		{
+			boneZones[boneIndex] = EHitZone::Limb;
+		}
+
+		else
+		{
+			const int32 parentIndex = refSkeleton.GetParentIndex(boneIndex);
+			if (parentIndex != INDEX_NONE)
+			{
+				boneZones[boneIndex] = boneZones[parentIndex];
+			}
+		}
+	}
+
+	bodyZones.Init(EHitZone::Torso, mesh->Bodies.Num());
+
+	for (int32 bodyIndex = 0; bodyIndex < mesh->Bodies.Num(); ++bodyIndex)
+	{
+		const FBodyInstance* body = mesh->Bodies[bodyIndex];
+		if (!body || !boneZones.IsValidIndex(body->InstanceBoneIndex)) continue;
+
+		bodyZones[bodyIndex] = boneZones[body->InstanceBoneIndex];
+	}
+}
+
+EHitZone FHitZoneTable::Resolve(const FHitResult& hitResult) const
+{
+	INC_DWORD_STAT(STAT_HitZoneLookups);
+
+	const USkeletalMeshComponent* mesh = meshComponent.Get();
+
+	// Body index only means something when the hit was on our mesh, capsule hits count as torso
+	if (!mesh || hitResult.GetComponent() != mesh) return EHitZone::Torso;
+
+	if (bodyZones.IsValidIndex(hitResult.Item))
+		return bodyZones[hitResult.Item];
+
+	// Not a physics body hit, find the bone by name instead
+	if (hitResult.BoneName.IsNone()) return EHitZone::Torso;
+
+	INC_DWORD_STAT(STAT_HitZoneNameFallbacks);
+
+	const int32 boneIndex = mesh->GetBoneIndex(hitResult.BoneName);
+	return boneZones.IsValidIndex(boneIndex) ? boneZones[boneIndex] : EHitZone::Torso;
+}
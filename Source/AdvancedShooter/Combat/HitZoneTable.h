@@ -0,0 +1,49 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class USkeletalMeshComponent;
+
+// Part of the body a bullet landed on
+enum class EHitZone : uint8
+{
+	Torso,
+	Head,
+	Limb,
+
+	MAX,
+};
+
+/*
+Maps the physics bodies and bones of an enemy mesh to hit zones.
+Built once when the enemy starts play, resolving a hit is then an array lookup on the hit body index
+instead of comparing bone name strings.
+*/
+class ADVANCEDSHOOTER_API FHitZoneTable
+{
+public:
+	// Works out the zone of every bone and physics body, zone bones pass their zone down to their children
+	void Build(const USkeletalMeshComponent* mesh, FName headBoneName, const TArray<FName>& limbBoneNames);
+
+	void SetDamageMultiplier(EHitZone zone, float multiplier) { damageMultipliers[(int32)zone] = multiplier; }
+	float GetDamageMultiplier(EHitZone zone) const { return damageMultipliers[(int32)zone]; }
+
+	// Zone of the body the hit landed on, torso when the table doesnt know the body
+	EHitZone Resolve(const FHitResult& hitResult) const;
+
+	bool IsBuilt() const { return boneZones.Num() > 0; }
+
+private:
+	// Zone per bone index of the reference skeleton
+	TArray<EHitZone> boneZones;
+
+	// Zone per physics body index, this is what FHitResult::Item holds for skeletal mesh hits
+	TArray<EHitZone> bodyZones;
+
+	// Used to look up bones by name when a hit has no body index
+	TWeakObjectPtr<const USkeletalMeshComponent> meshComponent;
+
+	float damageMultipliers[(int32)EHitZone::MAX] = { 1.f, 1.f, 1.f };
+};
@@ -0,0 +1,352 @@
+#include "HitscanSubsystem.h"
+#include <AdvancedShooter/AdvancedShooter.h>
+#include <AdvancedShooter/ShooterCharacter.h>
+#include <AdvancedShooter/AI/Enemy.h>
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Hitscan Sync Trace"), STAT_HitscanSyncTrace, STATGROUP_AdvancedShooter);
+DECLARE_CYCLE_STAT(TEXT("Hitscan Async Tick"), STAT_HitscanAsyncTick, STATGROUP_AdvancedShooter);
+DECLARE_CYCLE_STAT(TEXT("Hitscan Penetration Trace"), STAT_HitscanPenetrationTrace, STATGROUP_AdvancedShooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Hitscan Pending Shots"), STAT_HitscanPendingShots, STATGROUP_AdvancedShooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hitscan Penetrations"), STAT_HitscanPenetrations, STATGROUP_AdvancedShooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Hitscan Penetration Buffers"), STAT_HitscanPenetrationBuffers, STATGROUP_AdvancedShooter);
+
+static TAutoConsoleVariable<int32> CVarHitscanAsync(
+	TEXT("Shooter.Hitscan.Async"),
+	1,
+	TEXT("0: trace each bullet on the game thread when it is fired.\n")
+	TEXT("1: batch the bullets fired each frame into async traces and resolve them together."),
+	ECVF_Default);
+
+void UHitscanSubsystem::Initialize(FSubsystemCollectionBase& collection)
+{
+	Super::Initialize(collection);
+
+	traceDelegate.BindUObject(this, &UHitscanSubsystem::OnTraceCompleted);
+}
+
+void UHitscanSubsystem::Deinitialize()
+{
+	queuedShots.Empty();
+	pendingShots.Empty();
+	penetrationBuffers.Empty();
+	freePenetrationBuffers.Empty();
+	traceDelegate.Unbind();
+
+	SET_DWORD_STAT(STAT_HitscanPenetrationBuffers, 0);
+
+	Super::Deinitialize();
+}
+
+TStatId UHitscanSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UHitscanSubsystem, STATGROUP_Tickables);
+}
+
+bool UHitscanSubsystem::DoesSupportWorldType(EWorldType::Type worldType) const
+{
+	return worldType == EWorldType::Game || worldType == EWorldType::PIE;
+}
+
+bool UHitscanSubsystem::IsAsyncEnabled()
+{
+	return CVarHitscanAsync.GetValueOnGameThread() != 0;
+}
+
+void UHitscanSubsystem::QueueShot(const FHitscanShot& shot)
+{
+	if (!IsAsyncEnabled())
+	{
+		// Legacy path, trace and resolve straight away
+		FHitscanShot syncShot = shot;
+		TraceShotSync(syncShot);
+		ResolveShot(syncShot);
+		return;
+	}
+
+	FHitscanShot& queuedShot = queuedShots.Add_GetRef(shot);
+	queuedShot.shotId = nextShotId++;
+	queuedShot.stage = EHitscanStage::Crosshair;
+	queuedShot.bTraceComplete = queuedShot.bCrosshairResolved;
+}
+
+void UHitscanSubsystem::QueueShots(TArrayView<const FHitscanShot> shots)
+{
+	for (const FHitscanShot& shot : shots)
+	{
+		QueueShot(shot);
+	}
+}
+
+void UHitscanSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_HitscanAsyncTick);
+
+	// Apply everything that came back since last frame in one batch
+	ResolveShots();
+
+	// Shots fired this frame go out together, skipping the crosshair stage when it was already answered
+	for (FHitscanShot& shot : queuedShots)
+	{
+		if (!shot.bCrosshairResolved)
+		{
+			SubmitAsyncTrace(shot, shot.crosshairStart, shot.crosshairEnd);
+		}
+		pendingShots.Add(MoveTemp(shot));
+	}
+	queuedShots.Reset();
+
+	// Crosshair traces that came back start their barrel trace
+	for (FHitscanShot& shot : pendingShots)
+	{
+		if (shot.stage != EHitscanStage::Crosshair || !shot.bTraceComplete) continue;
+
+		shot.stage = EHitscanStage::Barrel;
+		shot.bTraceComplete = false;
+
+		SubmitAsyncTrace(shot, shot.muzzleTransform.GetLocation(), GetBarrelTraceEnd(shot, shot.aimLocation));
+	}
+
+	// Penetrating shots whose last segment came back trace on from where the bullet left the last hit
+	for (FHitscanShot& shot : pendingShots)
+	{
+		if (shot.stage != EHitscanStage::Penetration || !shot.bTraceComplete) continue;
+
+		FVector segmentStart;
+		FVector segmentEnd;
+		FCollisionQueryParams queryParams(SCENE_QUERY_STAT(HitscanPenetration));
+
+		if (!GetPenetrationSegment(shot, segmentStart, segmentEnd, queryParams))
+		{
+			shot.stage = EHitscanStage::Resolved;
+			continue;
+		}
+
+		shot.bTraceComplete = false;
+		SubmitAsyncTrace(shot, segmentStart, segmentEnd, queryParams);
+	}
+
+	SET_DWORD_STAT(STAT_HitscanPendingShots, pendingShots.Num());
+}
+
+void UHitscanSubsystem::TraceShotSync(FHitscanShot& shot)
+{
+	SCOPE_CYCLE_COUNTER(STAT_HitscanSyncTrace);
+
+	if (!shot.bCrosshairResolved)
+	{
+		// Trace from the camera through the crosshair
+		FHitResult crosshairHit;
+		const bool bCrosshairHit = GetWorld()->LineTraceSingleByChannel(crosshairHit, shot.crosshairStart, shot.crosshairEnd, ECollisionChannel::ECC_Visibility);
+		shot.aimLocation = GetAimLocation(shot, crosshairHit, bCrosshairHit);
+	}
+
+	// Perform second trace from gun barrel
+	GetWorld()->LineTraceSingleByChannel(shot.hitResult, shot.muzzleTransform.GetLocation(), GetBarrelTraceEnd(shot, shot.aimLocation), ECollisionChannel::ECC_Visibility);
+
+	shot.bBlockingHit = shot.hitResult.bBlockingHit;
+	FinishBarrelTrace(shot);
+
+	if (shot.stage != EHitscanStage::Penetration) return;
+
+	SCOPE_CYCLE_COUNTER(STAT_HitscanPenetrationTrace);
+
+	FVector segmentStart;
+	FVector segmentEnd;
+	FCollisionQueryParams queryParams(SCENE_QUERY_STAT(HitscanPenetration));
+
+	while (GetPenetrationSegment(shot, segmentStart, segmentEnd, queryParams))
+	{
+		FHitResult nextHit;
+		if (!GetWorld()->LineTraceSingleByChannel(nextHit, segmentStart, segmentEnd, ECollisionChannel::ECC_Visibility, queryParams))
+		{
+			// Came out the other side and hit nothing else
+			shot.trailEnd = segmentEnd;
+			break;
+		}
+
+		penetrationBuffers[shot.penetrationBuffer].Add(nextHit);
+	}
+
+	shot.stage = EHitscanStage::Resolved;
+}
+
+void UHitscanSubsystem::FinishBarrelTrace(FHitscanShot& shot)
+{
+	if (!shot.bBlockingHit)
+	{
+		shot.hitResult.Location = shot.aimLocation;
+		shot.trailEnd = shot.aimLocation;
+		shot.stage = EHitscanStage::Resolved;
+		return;
+	}
+
+	shot.trailEnd = shot.hitResult.ImpactPoint;
+
+	if (shot.maxHits <= 1)
+	{
+		shot.stage = EHitscanStage::Resolved;
+		return;
+	}
+
+	shot.penetrationBuffer = AcquirePenetrationBuffer();
+	penetrationBuffers[shot.penetrationBuffer].Add(shot.hitResult);
+	shot.stage = EHitscanStage::Penetration;
+
+	// Ready for the first segment
+	shot.bTraceComplete = true;
+}
+
+bool UHitscanSubsystem::GetPenetrationSegment(FHitscanShot& shot, FVector& outStart, FVector& outEnd, FCollisionQueryParams& outQueryParams) const
+{
+	if (!penetrationBuffers.IsValidIndex(shot.penetrationBuffer)) return false;
+	const FPenetrationHitBuffer& hits = penetrationBuffers[shot.penetrationBuffer];
+
+	const int32 maxHits = FMath::Clamp(shot.maxHits, 1, MAX_PENETRATION_HITS);
+	if (hits.Num() == 0 || hits.Num() >= maxHits) return false;
+
+	const FHitResult& lastHit = hits.Last();
+	shot.trailEnd = lastHit.ImpactPoint;
+
+	outEnd = GetBarrelTraceEnd(shot, shot.aimLocation);
+	const FVector direction = (outEnd - shot.muzzleTransform.GetLocation()).GetSafeNormal();
+
+	// Bullets go straight through enemies, the segment just stops tracing against them
+	for (const FHitResult& hit : hits)
+	{
+		AActor* hitActor = hit.GetActor();
+		if (Cast<AEnemy>(hitActor)) outQueryParams.AddIgnoredActor(hitActor);
+	}
+
+	outStart = lastHit.ImpactPoint;
+
+	if (!Cast<AEnemy>(lastHit.GetActor()))
+	{
+		UPrimitiveComponent* surface = lastHit.GetComponent();
+		if (!surface || shot.penetrationDepth <= 0.f) return false;
+
+		// Trace back from as deep as the bullet can go, the first face found is where it leaves the surface it hit
+		const FVector depthPoint = lastHit.ImpactPoint + direction * shot.penetrationDepth;
+
+		FHitResult exitHit;
+		if (!surface->LineTraceComponent(exitHit, depthPoint, lastHit.ImpactPoint, FCollisionQueryParams(SCENE_QUERY_STAT(HitscanPenetrationExit)))) return false;
+
+		// Still inside at the full depth, thicker than the bullet can get through
+		if (exitHit.bStartPenetrating) return false;
+
+		// Nudged off the exit face so the next segment doesnt start inside the surface
+		outStart = exitHit.ImpactPoint + direction;
+	}
+
+	INC_DWORD_STAT(STAT_HitscanPenetrations);
+	return true;
+}
+
+FVector UHitscanSubsystem::GetAimLocation(const FHitscanShot& shot, const FHitResult& crosshairHit, bool bCrosshairHit)
+{
+	return bCrosshairHit ? crosshairHit.Location : shot.crosshairEnd;
+}
+
+FVector UHitscanSubsystem::GetBarrelTraceEnd(const FHitscanShot& shot, const FVector& aimLocation)
+{
+	const FVector muzzleLocation = shot.muzzleTransform.GetLocation();
+	const FVector startToEnd = aimLocation - muzzleLocation;
+
+	return muzzleLocation + startToEnd * 1.25f;
+}
+
+void UHitscanSubsystem::SubmitAsyncTrace(const FHitscanShot& shot, const FVector& start, const FVector& end,
+	const FCollisionQueryParams& queryParams)
+{
+	GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Single, start, end, ECollisionChannel::ECC_Visibility,
+		queryParams, FCollisionResponseParams::DefaultResponseParam, &traceDelegate, shot.shotId);
+}
+
+void UHitscanSubsystem::OnTraceCompleted(const FTraceHandle& handle, FTraceDatum& datum)
+{
+	FHitscanShot* shot = pendingShots.FindByPredicate([&datum](const FHitscanShot& pendingShot)
+	{
+		return pendingShot.shotId == datum.UserData;
+	});
+
+	if (!shot) return;
+
+	const FHitResult* blockingHit = datum.OutHits.FindByPredicate([](const FHitResult& hit) { return hit.bBlockingHit; });
+
+	if (shot->stage == EHitscanStage::Penetration)
+	{
+		if (!blockingHit)
+		{
+			// Came out the other side and hit nothing else
+			shot->trailEnd = datum.End;
+			shot->stage = EHitscanStage::Resolved;
+			return;
+		}
+
+		// Next segment is submitted from tick
+		penetrationBuffers[shot->penetrationBuffer].Add(*blockingHit);
+		shot->bTraceComplete = true;
+		return;
+	}
+
+	shot->bBlockingHit = blockingHit != NULL;
+	shot->hitResult = blockingHit ? *blockingHit : FHitResult();
+
+	switch (shot->stage)
+	{
+		case EHitscanStage::Crosshair:
+			// Barrel trace is submitted from tick, not from inside the trace callback
+			shot->aimLocation = GetAimLocation(*shot, shot->hitResult, shot->bBlockingHit);
+			shot->bTraceComplete = true;
+			break;
+
+		case EHitscanStage::Barrel:
+			FinishBarrelTrace(*shot);
+			break;
+
+		default:
+			break;
+	}
+}
+
+void UHitscanSubsystem::ResolveShots()
+{
+	for (FHitscanShot& shot : pendingShots)
+	{
+		if (shot.stage != EHitscanStage::Resolved) continue;
+		ResolveShot(shot);
+	}
+
+	pendingShots.RemoveAll([](const FHitscanShot& shot) { return shot.stage == EHitscanStage::Resolved; });
+}
+
+void UHitscanSubsystem::ResolveShot(FHitscanShot& shot)
+{
+	AShooterCharacter* shooter = shot.shooter.Get();
+	if (shooter) shooter->ResolveBullet(shot, GetPenetrationHits(shot));
+
+	ReleasePenetrationBuffer(shot);
+}
+
+TArrayView<const FHitResult> UHitscanSubsystem::GetPenetrationHits(const FHitscanShot& shot) const
+{
+	if (!penetrationBuffers.IsValidIndex(shot.penetrationBuffer)) return TArrayView<const FHitResult>();
+	return penetrationBuffers[shot.penetrationBuffer];
+}
+
+int32 UHitscanSubsystem::AcquirePenetrationBuffer()
+{
+	if (freePenetrationBuffers.Num() > 0) return freePenetrationBuffers.Pop(false);
+
+	SET_DWORD_STAT(STAT_HitscanPenetrationBuffers, penetrationBuffers.Num() + 1);
+	return penetrationBuffers.AddDefaulted();
+}
+
+void UHitscanSubsystem::ReleasePenetrationBuffer(FHitscanShot& shot)
+{
+	if (!penetrationBuffers.IsValidIndex(shot.penetrationBuffer)) return;
+
+	penetrationBuffers[shot.penetrationBuffer].Reset();
+	freePenetrationBuffers.Add(shot.penetrationBuffer);
+	shot.penetrationBuffer = INDEX_NONE;
+}
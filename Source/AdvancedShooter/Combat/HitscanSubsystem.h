@@ -0,0 +1,157 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+#include <AdvancedShooter/Combat/PenetrationHitBuffer.h>
+#include "HitscanSubsystem.generated.h"
+
+class AShooterCharacter;
+
+// Where a shot is in the async trace pipeline
+enum class EHitscanStage : uint8
+{
+	// Waiting on the trace from the camera through the crosshair
+	Crosshair,
+
+	// Waiting on the trace from the muzzle towards the crosshair hit
+	Barrel,
+
+	// Waiting on the trace from where the bullet left the last thing it passed through
+	Penetration,
+
+	// Trace results are in, ready to apply damage and effects
+	Resolved,
+};
+
+// A single bullet waiting to be traced and resolved
+struct FHitscanShot
+{
+	// Character that fired the shot
+	TWeakObjectPtr<AShooterCharacter> shooter;
+
+	// Muzzle transform when the shot was fired
+	FTransform muzzleTransform;
+
+	// World time the shot was fired, may be partway through the frame it was queued on
+	float fireTime = 0.f;
+
+	// Ray through the crosshair when the shot was fired
+	FVector crosshairStart = FVector::ZeroVector;
+	FVector crosshairEnd = FVector::ZeroVector;
+
+	// Damage captured from the weapon when fired, so swapping weapons mid flight doesnt change it
+	float damage = 0.f;
+	float headShotDamage = 0.f;
+
+	// Penetration captured from the weapon, one hit means the bullet stops at the first thing it hits
+	int32 maxHits = 1;
+	float penetrationDepth = 0.f;
+	float penetrationFalloff = 0.f;
+
+	// Crosshair hit, or the end of the crosshair ray when nothing was hit
+	FVector aimLocation = FVector::ZeroVector;
+
+	// True when the shooter already filled in aimLocation from its crosshair cache
+	bool bCrosshairResolved = false;
+
+	// Result of the barrel trace
+	FHitResult hitResult;
+
+	// True when the barrel trace hit something
+	bool bBlockingHit = false;
+
+	// Subsystem hit buffer holding every hit along the bullets path starting with the barrel trace hit,
+	// only taken by penetrating shots that hit something
+	int32 penetrationBuffer = INDEX_NONE;
+
+	// Where the bullet stopped, for the trail
+	FVector trailEnd = FVector::ZeroVector;
+
+	// ASYNC PIPELINE
+	EHitscanStage stage = EHitscanStage::Crosshair;
+	uint32 shotId = 0;
+	bool bTraceComplete = false;
+};
+
+/*
+Collects the shots fired each frame and traces them either straight away on the game thread (sync)
+or as a batch of async traces that are resolved together on a later frame (async).
+Toggle with Shooter.Hitscan.Async to compare the two in benchmarks.
+*/
+UCLASS()
+class ADVANCEDSHOOTER_API UHitscanSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& collection) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Traces the shot now in sync mode, or queues it for the next async batch
+	void QueueShot(const FHitscanShot& shot);
+
+	// Queues every shot a weapon fired this tick together
+	void QueueShots(TArrayView<const FHitscanShot> shots);
+
+	// True when Shooter.Hitscan.Async is set
+	static bool IsAsyncEnabled();
+
+	// Every hit along a penetrating shots path, empty for shots that stop at their first hit
+	TArrayView<const FHitResult> GetPenetrationHits(const FHitscanShot& shot) const;
+
+protected:
+	virtual bool DoesSupportWorldType(EWorldType::Type worldType) const override;
+
+private:
+	// Runs every trace for a shot on the game thread
+	void TraceShotSync(FHitscanShot& shot);
+
+	// Barrel trace is in, starts following the bullet through what it hit when it can penetrate
+	void FinishBarrelTrace(FHitscanShot& shot);
+
+	/*
+	Works out where the next penetration segment starts from the shots last hit. Enemies are passed straight through,
+	anything else only when the bullet comes out of it within the penetration depth. False once the bullet stops, with trailEnd set.
+	*/
+	bool GetPenetrationSegment(FHitscanShot& shot, FVector& outStart, FVector& outEnd, FCollisionQueryParams& outQueryParams) const;
+
+	// Location the barrel trace aims at, the crosshair hit or the end of the crosshair ray
+	static FVector GetAimLocation(const FHitscanShot& shot, const FHitResult& crosshairHit, bool bCrosshairHit);
+
+	// End of the barrel trace, overshoots the aim location slightly so we still hit the surface
+	static FVector GetBarrelTraceEnd(const FHitscanShot& shot, const FVector& aimLocation);
+
+	void SubmitAsyncTrace(const FHitscanShot& shot, const FVector& start, const FVector& end,
+		const FCollisionQueryParams& queryParams = FCollisionQueryParams::DefaultQueryParam);
+
+	// Called by the engine when an async trace finishes
+	void OnTraceCompleted(const FTraceHandle& handle, FTraceDatum& datum);
+
+	// Hands resolved shots back to their shooters
+	void ResolveShots();
+
+	// Hands a shot back to its shooter and returns its hit buffer to the pool
+	void ResolveShot(FHitscanShot& shot);
+
+	int32 AcquirePenetrationBuffer();
+	void ReleasePenetrationBuffer(FHitscanShot& shot);
+
+	// Shots fired this frame, submitted together in tick
+	TArray<FHitscanShot> queuedShots;
+
+	// Shots waiting on async trace results
+	TArray<FHitscanShot> pendingShots;
+
+	// Hit buffers shared by every penetrating shot in flight, shots only carry an index so the rest never pay for them
+	TArray<FPenetrationHitBuffer> penetrationBuffers;
+	TArray<int32> freePenetrationBuffers;
+
+	FTraceDelegate traceDelegate;
+
+	uint32 nextShotId = 1;
+};
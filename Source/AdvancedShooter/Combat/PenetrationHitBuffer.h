@@ -0,0 +1,12 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/HitResult.h"
+
+// Most surfaces and enemies a single bullet can pass through
+constexpr int32 MAX_PENETRATION_HITS = 8;
+
+// Hits along one bullets path, fixed capacity so penetration traces never allocate
+typedef TArray<FHitResult, TFixedAllocator<MAX_PENETRATION_HITS>> FPenetrationHitBuffer;
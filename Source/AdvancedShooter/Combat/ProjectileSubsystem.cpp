@@ -0,0 +1,326 @@
+#include "ProjectileSubsystem.h"
+#include <AdvancedShooter/AdvancedShooter.h>
+#include <AdvancedShooter/BulletHitInterface.h>
+#include <AdvancedShooter/AI/Enemy.h>
+#include <AdvancedShooter/Combat/DamagePipelineSubsystem.h>
+#include <AdvancedShooter/Effects/ParticlePoolSubsystem.h>
+#include <DrawDebugHelpers.h>
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Projectile Integrate"), STAT_ProjectileIntegrate, STATGROUP_AdvancedShooter);
+DECLARE_CYCLE_STAT(TEXT("Projectile Submit Traces"), STAT_ProjectileSubmitTraces, STATGROUP_AdvancedShooter);
+DECLARE_CYCLE_STAT(TEXT("Projectile Dispatch Hits"), STAT_ProjectileDispatchHits, STATGROUP_AdvancedShooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Live Projectiles"), STAT_LiveProjectiles, STATGROUP_AdvancedShooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Projectile Traces"), STAT_ProjectileTraces, STATGROUP_AdvancedShooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Projectile Hits"), STAT_ProjectileHits, STATGROUP_AdvancedShooter);
+
+static TAutoConsoleVariable<int32> CVarProjectileDebug(
+	TEXT("Shooter.Projectiles.Debug"),
+	0,
+	TEXT("1: draw a point at every live projectile."),
+	ECVF_Cheat);
+
+void UProjectileSubsystem::Initialize(FSubsystemCollectionBase& collection)
+{
+	Super::Initialize(collection);
+
+	traceDelegate.BindUObject(this, &UProjectileSubsystem::OnTraceCompleted);
+
+	positions.Reserve(initialCapacity);
+	velocities.Reserve(initialCapacity);
+	traceStarts.Reserve(initialCapacity);
+	lifetimes.Reserve(initialCapacity);
+	gravityScales.Reserve(initialCapacity);
+	drags.Reserve(initialCapacity);
+	radii.Reserve(initialCapacity);
+	damages.Reserve(initialCapacity);
+	headShotDamages.Reserve(initialCapacity);
+	ids.Reserve(initialCapacity);
+	tracePending.Reserve(initialCapacity);
+	owners.Reserve(initialCapacity);
+	instigators.Reserve(initialCapacity);
+	impactParticles.Reserve(initialCapacity);
+	idToIndex.Reserve(initialCapacity);
+}
+
+void UProjectileSubsystem::Deinitialize()
+{
+	traceDelegate.Unbind();
+
+	positions.Empty();
+	velocities.Empty();
+	traceStarts.Empty();
+	lifetimes.Empty();
+	gravityScales.Empty();
+	drags.Empty();
+	radii.Empty();
+	damages.Empty();
+	headShotDamages.Empty();
+	ids.Empty();
+	tracePending.Empty();
+	owners.Empty();
+	instigators.Empty();
+	impactParticles.Empty();
+	idToIndex.Empty();
+	completedHits.Empty();
+
+	Super::Deinitialize();
+}
+
+TStatId UProjectileSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UProjectileSubsystem, STATGROUP_Tickables);
+}
+
+bool UProjectileSubsystem::DoesSupportWorldType(EWorldType::Type worldType) const
+{
+	return worldType == EWorldType::Game || worldType == EWorldType::PIE;
+}
+
+uint32 UProjectileSubsystem::SpawnProjectile(const FProjectileSpawnParams& params)
+{
+	const uint32 projectileId = nextProjectileId++;
+
+	idToIndex.Add(projectileId, positions.Num());
+
+	// Placed where it has got to by now under gravity, the first sweep still starts at the muzzle
+	const float timeInFlight = FMath::Clamp(params.timeInFlight, 0.f, FMath::Max(params.lifetime, 0.f));
+	const FVector gravity = FVector(0.f, 0.f, GetWorld()->GetGravityZ() * params.gravityScale);
+
+	positions.Add(params.location + params.velocity * timeInFlight + gravity * (0.5f * timeInFlight * timeInFlight));
+	velocities.Add(params.velocity + gravity * timeInFlight);
+	traceStarts.Add(params.location);
+	lifetimes.Add(params.lifetime - timeInFlight);
+	gravityScales.Add(params.gravityScale);
+	drags.Add(params.drag);
+	radii.Add(params.radius);
+	damages.Add(params.damage);
+	headShotDamages.Add(params.headShotDamage);
+	ids.Add(projectileId);
+	tracePending.Add(false);
+	owners.Add(params.owner);
+	instigators.Add(params.instigator);
+	impactParticles.Add(params.impactParticles);
+
+	return projectileId;
+}
+
+void UProjectileSubsystem::DestroyProjectile(uint32 projectileId)
+{
+	const int32* index = idToIndex.Find(projectileId);
+	if (!index) return;
+
+	RemoveAtSwap(*index);
+}
+
+void UProjectileSubsystem::Tick(float DeltaTime)
+{
+	// Hits from last frames traces first, so those projectiles dont move on
+	DispatchHits();
+
+	Integrate(DeltaTime);
+
+	SubmitTraces();
+
+	SET_DWORD_STAT(STAT_LiveProjectiles, positions.Num());
+
+	if (CVarProjectileDebug.GetValueOnGameThread() == 0) return;
+
+	for (const FVector& position : positions)
+	{
+		DrawDebugPoint(GetWorld(), position, 6.f, FColor::Orange, false, -1.f);
+	}
+}
+
+void UProjectileSubsystem::Integrate(float deltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ProjectileIntegrate);
+
+	const int32 count = positions.Num();
+	const FVector gravity = FVector(0.f, 0.f, GetWorld()->GetGravityZ());
+
+	FVector* RESTRICT position = positions.GetData();
+	FVector* RESTRICT velocity = velocities.GetData();
+	float* RESTRICT lifetime = lifetimes.GetData();
+	const float* RESTRICT gravityScale = gravityScales.GetData();
+	const float* RESTRICT drag = drags.GetData();
+
+	// Straight loop over the arrays with no branches so the compiler can vectorize it
+	for (int32 i = 0; i < count; ++i)
+	{
+		// Only as far as the lifetime left, expired projectiles stay put until their last segment is swept
+		const float step = FMath::Clamp(lifetime[i], 0.f, deltaTime);
+
+		velocity[i] = velocity[i] * FMath::Max(1.f - drag[i] * step, 0.f) + gravity * (gravityScale[i] * step);
+		position[i] += velocity[i] * step;
+		lifetime[i] -= deltaTime;
+	}
+
+	// Expired projectiles whose whole path has been swept without a hit go, backwards so swapping doesnt skip any
+	for (int32 i = count - 1; i >= 0; --i)
+	{
+		if (lifetimes[i] > 0.f || tracePending[i] || traceStarts[i] != positions[i]) continue;
+		RemoveAtSwap(i);
+	}
+}
+
+void UProjectileSubsystem::SubmitTraces()
+{
+	SCOPE_CYCLE_COUNTER(STAT_ProjectileSubmitTraces);
+
+	const int32 count = positions.Num();
+	if (count == 0) return;
+
+	int32 traceCount = FMath::Min(count, FMath::Max(traceBudget, 1));
+
+	// Expired projectiles only leave once their last segment is swept, so they go before the round robin
+	for (int32 index = 0; index < count && traceCount > 0; ++index)
+	{
+		if (lifetimes[index] > 0.f || tracePending[index] || traceStarts[index] == positions[index]) continue;
+
+		SubmitTrace(index);
+		--traceCount;
+	}
+
+	if (traceCursor >= count) traceCursor = 0;
+
+	for (int32 traced = 0; traced < traceCount; ++traced)
+	{
+		const int32 index = traceCursor;
+		traceCursor = (traceCursor + 1) % count;
+
+		// Still waiting on the last sweep for this one
+		if (tracePending[index]) continue;
+
+		SubmitTrace(index);
+	}
+}
+
+void UProjectileSubsystem::SubmitTrace(int32 index)
+{
+	const FVector start = traceStarts[index];
+	const FVector end = positions[index];
+
+	FCollisionQueryParams queryParams(SCENE_QUERY_STAT(ProjectileSweep));
+	queryParams.AddIgnoredActor(owners[index].Get());
+
+	if (radii[index] > 0.f)
+	{
+		GetWorld()->AsyncSweepByChannel(EAsyncTraceType::Single, start, end, FQuat::Identity, ECollisionChannel::ECC_Visibility,
+			FCollisionShape::MakeSphere(radii[index]), queryParams, FCollisionResponseParams::DefaultResponseParam, &traceDelegate, ids[index]);
+	}
+
+	else
+	{
+		GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Single, start, end, ECollisionChannel::ECC_Visibility,
+			queryParams, FCollisionResponseParams::DefaultResponseParam, &traceDelegate, ids[index]);
+	}
+
+	INC_DWORD_STAT(STAT_ProjectileTraces);
+
+	// Next sweep continues from here
+	traceStarts[index] = end;
+	tracePending[index] = true;
+}
+
+void UProjectileSubsystem::OnTraceCompleted(const FTraceHandle& handle, FTraceDatum& datum)
+{
+	const int32* index = idToIndex.Find(datum.UserData);
+
+	// Projectile expired while its trace was in flight
+	if (!index) return;
+
+	tracePending[*index] = false;
+
+	const FHitResult* blockingHit = datum.OutHits.FindByPredicate([](const FHitResult& hit) { return hit.bBlockingHit; });
+	if (!blockingHit) return;
+
+	// Dispatched from tick, not from inside the trace callback
+	completedHits.Emplace(datum.UserData, *blockingHit);
+}
+
+void UProjectileSubsystem::DispatchHits()
+{
+	if (completedHits.Num() == 0) return;
+
+	SCOPE_CYCLE_COUNTER(STAT_ProjectileDispatchHits);
+
+	for (const TPair<uint32, FHitResult>& completedHit : completedHits)
+	{
+		const int32* index = idToIndex.Find(completedHit.Key);
+		if (!index) continue;
+
+		const int32 hitIndex = *index;
+
+		DispatchHit(hitIndex, completedHit.Value);
+		RemoveAtSwap(hitIndex);
+	}
+
+	completedHits.Reset();
+}
+
+void UProjectileSubsystem::DispatchHit(int32 index, const FHitResult& hitResult)
+{
+	INC_DWORD_STAT(STAT_ProjectileHits);
+
+	AActor* hitActor = hitResult.GetActor();
+	AActor* owner = owners[index].Get();
+	AController* instigator = instigators[index].Get();
+
+	IBulletHitInterface* bulletHitInterface = Cast<IBulletHitInterface>(hitActor);
+
+	if (!bulletHitInterface)
+	{
+		if (!impactParticles[index]) return;
+		UParticlePoolSubsystem::SpawnPooledEmitter(this, impactParticles[index], hitResult.ImpactPoint);
+		return;
+	}
+
+	bulletHitInterface->BulletHit_Implementation(hitResult, owner, instigator);
+
+	AEnemy* hitEnemy = Cast<AEnemy>(hitActor);
+	if (!hitEnemy) return;
+
+	const EHitZone hitZone = hitEnemy->GetHitZone(hitResult);
+	const bool bIsHeadShot = hitZone == EHitZone::Head;
+
+	FQueuedDamage damage;
+	damage.target = hitEnemy;
+	damage.instigator = instigator;
+	damage.causer = owner;
+	damage.amount = (bIsHeadShot ? headShotDamages[index] : damages[index]) * hitEnemy->GetHitZoneDamageMultiplier(hitZone);
+	damage.hitLocation = hitResult.ImpactPoint;
+	damage.bShowDamageNumber = true;
+	damage.bIsHeadShot = bIsHeadShot;
+
+	UDamagePipelineSubsystem::QueueDamage(this, damage);
+}
+
+void UProjectileSubsystem::RemoveAtSwap(int32 index)
+{
+	const int32 lastIndex = positions.Num() - 1;
+	if (!positions.IsValidIndex(index)) return;
+
+	idToIndex.Remove(ids[index]);
+
+	// Last projectile moves into the freed slot
+	if (index != lastIndex)
+	{
+		idToIndex.Add(ids[lastIndex], index);
+	}
+
+	positions.RemoveAtSwap(index, 1, false);
+	velocities.RemoveAtSwap(index, 1, false);
+	traceStarts.RemoveAtSwap(index, 1, false);
+	lifetimes.RemoveAtSwap(index, 1, false);
+	gravityScales.RemoveAtSwap(index, 1, false);
+	drags.RemoveAtSwap(index, 1, false);
+	radii.RemoveAtSwap(index, 1, false);
+	damages.RemoveAtSwap(index, 1, false);
+	headShotDamages.RemoveAtSwap(index, 1, false);
+	ids.RemoveAtSwap(index, 1, false);
+	tracePending.RemoveAtSwap(index, 1, false);
+	owners.RemoveAtSwap(index, 1, false);
+	instigators.RemoveAtSwap(index, 1, false);
+	impactParticles.RemoveAtSwap(index, 1, false);
+}
@@ -0,0 +1,133 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+#include "ProjectileSubsystem.generated.h"
+
+class UParticleSystem;
+
+// Everything needed to launch a projectile
+struct FProjectileSpawnParams
+{
+	FVector location = FVector::ZeroVector;
+	FVector velocity = FVector::ZeroVector;
+
+	// Multiplier on world gravity, 0 flies straight
+	float gravityScale = 1.f;
+
+	// Fraction of velocity lost per second
+	float drag = 0.f;
+
+	// Seconds before the projectile is removed without hitting anything
+	float lifetime = 5.f;
+
+	// Seconds the projectile has already been flying, for rounds fired partway through a frame
+	float timeInFlight = 0.f;
+
+	// Sweep radius, 0 uses a line trace
+	float radius = 0.f;
+
+	float damage = 0.f;
+	float headShotDamage = 0.f;
+
+	TWeakObjectPtr<AActor> owner;
+	TWeakObjectPtr<AController> instigator;
+
+	// Played where the projectile hits something that isnt a bullet hit interface
+	UParticleSystem* impactParticles = NULL;
+};
+
+/*
+Simulates projectiles without an actor per round. Every projectile lives in a set of parallel arrays
+that are integrated in one loop, and its path since the last trace is swept with batched async traces.
+Only traceBudget projectiles are traced each frame, in round robin order; the rest keep extending
+their segment so nothing tunnels, hits just land a few frames later under heavy load.
+A projectile that runs out of lifetime stops where it is and is only removed once its last segment is swept.
+*/
+UCLASS(Config = Game)
+class ADVANCEDSHOOTER_API UProjectileSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& collection) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Launches a projectile and returns its id, ids stay valid until the projectile is removed
+	uint32 SpawnProjectile(const FProjectileSpawnParams& params);
+
+	bool IsProjectileAlive(uint32 projectileId) const { return idToIndex.Contains(projectileId); }
+	void DestroyProjectile(uint32 projectileId);
+
+	int32 GetNumProjectiles() const { return positions.Num(); }
+
+protected:
+	virtual bool DoesSupportWorldType(EWorldType::Type worldType) const override;
+
+private:
+	// Applies gravity and drag and moves every projectile, then removes the expired ones with nothing left to sweep
+	void Integrate(float deltaTime);
+
+	// Submits sweeps for up to traceBudget projectiles, expired ones first, then starting where last frame left off
+	void SubmitTraces();
+
+	void SubmitTrace(int32 index);
+
+	// Hands hits that came back to the thing that was hit and removes the projectile
+	void DispatchHits();
+
+	void DispatchHit(int32 index, const FHitResult& hitResult);
+
+	// Called by the engine when an async trace finishes
+	void OnTraceCompleted(const FTraceHandle& handle, FTraceDatum& datum);
+
+	// Removes a projectile by swapping the last one into its slot
+	void RemoveAtSwap(int32 index);
+
+	// PROJECTILE ARRAYS, one entry per live projectile at the same index
+	TArray<FVector> positions;
+	TArray<FVector> velocities;
+
+	// Where the next sweep starts, the position at the last trace
+	TArray<FVector> traceStarts;
+
+	TArray<float> lifetimes;
+	TArray<float> gravityScales;
+	TArray<float> drags;
+	TArray<float> radii;
+	TArray<float> damages;
+	TArray<float> headShotDamages;
+	TArray<uint32> ids;
+	TArray<bool> tracePending;
+	TArray<TWeakObjectPtr<AActor>> owners;
+	TArray<TWeakObjectPtr<AController>> instigators;
+
+	UPROPERTY()
+	TArray<UParticleSystem*> impactParticles;
+
+	// Stable id to current array index
+	TMap<uint32, int32> idToIndex;
+
+	// Id and hit for every trace that hit something, filled by the trace callback
+	TArray<TPair<uint32, FHitResult>> completedHits;
+
+	FTraceDelegate traceDelegate;
+
+	uint32 nextProjectileId = 1;
+
+	// Where the round robin trace pass starts next frame
+	int32 traceCursor = 0;
+
+	// Most sweeps submitted per frame
+	UPROPERTY(Config)
+	int32 traceBudget = 1024;
+
+	// Arrays are reserved for this many projectiles up front
+	UPROPERTY(Config)
+	int32 initialCapacity = 10000;
+};
@@ -0,0 +1,216 @@
+#include "AssetStreamingSubsystem.h"
+#include <AdvancedShooter/AdvancedShooter.h>
+#include "Engine/AssetManager.h"
+#include "Engine/SkeletalMesh.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Asset Bundle Requests"), STAT_AssetBundleRequests, STATGROUP_AdvancedShooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Asset Bundle Prefetches"), STAT_AssetBundlePrefetches, STATGROUP_AdvancedShooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Asset Bundles Loaded"), STAT_AssetBundlesLoaded, STATGROUP_AdvancedShooter);
+DECLARE_MEMORY_STAT(TEXT("Asset Bundle Memory"), STAT_AssetBundleMemory, STATGROUP_AdvancedShooter);
+
+static FAutoConsoleCommandWithWorld DumpAssetStreamingCommand(
+	TEXT("Shooter.Streaming.Dump"),
+	TEXT("Logs load time and estimated memory of every asset bundle streamed into the world."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* world)
+	{
+		if (!world) return;
+
+		const UAssetStreamingSubsystem* streaming = world->GetSubsystem<UAssetStreamingSubsystem>();
+		if (!streaming) return;
+
+		streaming->LogStreamingStats();
+	}));
+
+bool UAssetStreamingSubsystem::DoesSupportWorldType(EWorldType::Type worldType) const
+{
+	return worldType == EWorldType::Game || worldType == EWorldType::PIE;
+}
+
+void UAssetStreamingSubsystem::Initialize(FSubsystemCollectionBase& collection)
+{
+	Super::Initialize(collection);
+
+	// Tiny and needed before anything streams, so just load it
+	placeholderMesh = placeholderItemMesh.LoadSynchronous();
+}
+
+void UAssetStreamingSubsystem::Deinitialize()
+{
+	LogStreamingStats();
+
+	for (TPair<uint32, FAssetBundle>& bundlePair : bundles)
+	{
+		FAssetBundle& bundle = bundlePair.Value;
+
+		if (bundle.bLoaded)
+		{
+			DEC_MEMORY_STAT_BY(STAT_AssetBundleMemory, bundle.resourceBytes);
+			DEC_DWORD_STAT(STAT_AssetBundlesLoaded);
+		}
+
+		if (!bundle.handle.IsValid()) continue;
+
+		if (bundle.handle->IsLoadingInProgress()) bundle.handle->CancelHandle();
+		else bundle.handle->ReleaseHandle();
+	}
+	bundles.Empty();
+
+	placeholderMesh = NULL;
+
+	Super::Deinitialize();
+}
+
+bool UAssetStreamingSubsystem::RequestAssets(const UObject* worldContext, EGameDataTable table, uint8 row, const TArray<FSoftObjectPath>& assets, FSimpleDelegate onLoaded)
+{
+	UWorld* world = worldContext ? worldContext->GetWorld() : NULL;
+	UAssetStreamingSubsystem* streaming = world ? world->GetSubsystem<UAssetStreamingSubsystem>() : NULL;
+
+	if (!streaming)
+	{
+		// Editor preview needs the assets this frame to draw the actor
+		for (const FSoftObjectPath& asset : assets)
+		{
+			asset.TryLoad();
+		}
+
+		onLoaded.ExecuteIfBound();
+		return true;
+	}
+
+	return streaming->AddRequest(table, row, assets, onLoaded);
+}
+
+void UAssetStreamingSubsystem::PrefetchRow(const UObject* worldContext, EGameDataTable table, uint8 row)
+{
+	UWorld* world = worldContext ? worldContext->GetWorld() : NULL;
+	UAssetStreamingSubsystem* streaming = world ? world->GetSubsystem<UAssetStreamingSubsystem>() : NULL;
+	if (!streaming || streaming->bundles.Contains(GetBundleKey(table, row))) return;
+
+	UDataTableRegistry* registry = UDataTableRegistry::Get();
+	if (!registry) return;
+
+	TArray<FSoftObjectPath> assetPaths;
+
+	switch (table)
+	{
+		case EGameDataTable::EGDT_Weapon:
+			if (const FWeaponDataTable* weaponRow = registry->GetWeaponRow((EWeaponType)row)) weaponRow->GetAssetPaths(assetPaths);
+			else return;
+			break;
+
+		case EGameDataTable::EGDT_Enemy:
+			if (const FEnemyDataTable* enemyRow = registry->GetEnemyRow((EEnemyType)row)) enemyRow->GetAssetPaths(assetPaths);
+			else return;
+			break;
+
+		default:
+			return;
+	}
+
+	INC_DWORD_STAT(STAT_AssetBundlePrefetches);
+
+	// Nobody is waiting yet, actors of the row that spawn before it finishes join the bundles list as usual
+	streaming->AddRequest(table, row, assetPaths, FSimpleDelegate());
+}
+
+bool UAssetStreamingSubsystem::AddRequest(EGameDataTable table, uint8 row, const TArray<FSoftObjectPath>& assets, FSimpleDelegate onLoaded)
+{
+	INC_DWORD_STAT(STAT_AssetBundleRequests);
+
+	const uint32 bundleKey = GetBundleKey(table, row);
+
+	if (FAssetBundle* bundle = bundles.Find(bundleKey))
+	{
+		if (bundle->bLoaded)
+		{
+			onLoaded.ExecuteIfBound();
+			return true;
+		}
+
+		bundle->onLoaded.Add(onLoaded);
+		return false;
+	}
+
+	FAssetBundle& bundle = bundles.Add(bundleKey);
+	bundle.assets = assets;
+	bundle.requestTime = FPlatformTime::Seconds();
+	bundle.onLoaded.Add(onLoaded);
+
+	if (assets.Num() == 0)
+	{
+		OnBundleLoaded(bundleKey);
+		return true;
+	}
+
+	// Completes inside this call when everything is already in memory
+	TSharedPtr<FStreamableHandle> handle = UAssetManager::GetStreamableManager().RequestAsyncLoad(assets,
+		FStreamableDelegate::CreateUObject(this, &UAssetStreamingSubsystem::OnBundleLoaded, bundleKey));
+
+	// Load callbacks can request other bundles and grow the map, so bundle may no longer be valid here
+	FAssetBundle* requested = bundles.Find(bundleKey);
+	if (!requested) return false;
+
+	requested->handle = handle;
+	return requested->bLoaded;
+}
+
+void UAssetStreamingSubsystem::OnBundleLoaded(uint32 bundleKey)
+{
+	FAssetBundle* bundle = bundles.Find(bundleKey);
+	if (!bundle || bundle->bLoaded) return;
+
+	bundle->bLoaded = true;
+	bundle->loadSeconds = FPlatformTime::Seconds() - bundle->requestTime;
+
+	for (const FSoftObjectPath& asset : bundle->assets)
+	{
+		const UObject* loadedAsset = asset.ResolveObject();
+		if (!loadedAsset) continue;
+
+		bundle->resourceBytes += loadedAsset->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+	}
+
+	INC_MEMORY_STAT_BY(STAT_AssetBundleMemory, bundle->resourceBytes);
+	INC_DWORD_STAT(STAT_AssetBundlesLoaded);
+
+	// Callbacks may request other bundles and grow the map, so take the list out first
+	TArray<FSimpleDelegate> waiting = MoveTemp(bundle->onLoaded);
+
+	for (FSimpleDelegate& onLoaded : waiting)
+	{
+		onLoaded.ExecuteIfBound();
+	}
+}
+
+void UAssetStreamingSubsystem::LogStreamingStats() const
+{
+	int64 totalBytes = 0;
+	double totalSeconds = 0.0;
+	int32 loadedBundles = 0;
+
+	for (const TPair<uint32, FAssetBundle>& bundlePair : bundles)
+	{
+		const FAssetBundle& bundle = bundlePair.Value;
+		const EGameDataTable table = (EGameDataTable)(bundlePair.Key >> 8);
+		const uint8 row = bundlePair.Key & 0xFF;
+
+		if (!bundle.bLoaded)
+		{
+			UE_LOG(LogTemp, Log, TEXT("Asset bundle %s row %d: %d assets, still loading"),
+				*UEnum::GetValueAsString(table), row, bundle.assets.Num());
+			continue;
+		}
+
+		UE_LOG(LogTemp, Log, TEXT("Asset bundle %s row %d: %d assets, %.2f ms, %.2f MB"),
+			*UEnum::GetValueAsString(table), row, bundle.assets.Num(), bundle.loadSeconds * 1000.0, bundle.resourceBytes / (1024.0 * 1024.0));
+
+		totalBytes += bundle.resourceBytes;
+		totalSeconds += bundle.loadSeconds;
+		++loadedBundles;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("Asset streaming: %d bundles loaded on demand, %.2f MB kept out of the data tables, %.2f ms spent streaming"),
+		loadedBundles, totalBytes / (1024.0 * 1024.0), totalSeconds * 1000.0);
+}
@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/StreamableManager.h"
+#include <AdvancedShooter/Data/DataTableRegistry.h>
+#include "AssetStreamingSubsystem.generated.h"
+
+class USkeletalMesh;
+
+// Adds the path of a soft reference column to a rows asset list, unset columns are skipped
+template<typename SoftPtrType>
+void AddAssetPath(const SoftPtrType& softPtr, TArray<FSoftObjectPath>& outPaths)
+{
+	if (softPtr.IsNull()) return;
+	outPaths.Add(softPtr.ToSoftObjectPath());
+}
+
+// The assets of one data table row, streamed in and released together
+struct FAssetBundle
+{
+	TArray<FSoftObjectPath> assets;
+
+	TSharedPtr<FStreamableHandle> handle;
+
+	// Waiting for the bundle to finish loading
+	TArray<FSimpleDelegate> onLoaded;
+
+	double requestTime = 0.0;
+	double loadSeconds = 0.0;
+
+	// Estimated size of everything in the bundle once loaded
+	int64 resourceBytes = 0;
+
+	bool bLoaded = false;
+};
+
+/*
+Streams in the soft referenced assets of a data table row the first time an actor of that row is spawned,
+or earlier when one is about to be, so loading a table no longer pulls every mesh, montage, sound and texture in with it.
+Bundles stay loaded for the life of the world so later actors of the same row get them straight away.
+The placeholder mesh is set in the [/Script/AdvancedShooter.AssetStreamingSubsystem] section of DefaultGame.ini.
+*/
+UCLASS(Config = Game)
+class ADVANCEDSHOOTER_API UAssetStreamingSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& collection) override;
+	virtual void Deinitialize() override;
+
+	/*
+	Calls onLoaded once every asset is in memory. Returns true when that already happened during the call,
+	false while the bundle streams in, in which case the caller should show a placeholder.
+	Outside game worlds, eg construction scripts in the editor, the assets are loaded synchronously.
+	*/
+	static bool RequestAssets(const UObject* worldContext, EGameDataTable table, uint8 row, const TArray<FSoftObjectPath>& assets, FSimpleDelegate onLoaded);
+
+	/*
+	Starts streaming a weapon or enemy rows bundle ahead of an actor of that row being spawned, eg when a player
+	gets near ground loot or a wave is queued. Only a hint, does nothing outside game worlds or once the bundle is requested.
+	*/
+	static void PrefetchRow(const UObject* worldContext, EGameDataTable table, uint8 row);
+
+	// Shown on items until their bundle is loaded, NULL if none is configured
+	USkeletalMesh* GetPlaceholderMesh() const { return placeholderMesh; }
+
+	// Logs load time and estimated memory of every bundle streamed into this world
+	void LogStreamingStats() const;
+
+protected:
+	virtual bool DoesSupportWorldType(EWorldType::Type worldType) const override;
+
+private:
+	bool AddRequest(EGameDataTable table, uint8 row, const TArray<FSoftObjectPath>& assets, FSimpleDelegate onLoaded);
+
+	void OnBundleLoaded(uint32 bundleKey);
+
+	static uint32 GetBundleKey(EGameDataTable table, uint8 row) { return ((uint32)table << 8) | row; }
+
+	TMap<uint32, FAssetBundle> bundles;
+
+	// Small mesh items show while streaming
+	UPROPERTY(Config)
+	TSoftObjectPtr<USkeletalMesh> placeholderItemMesh;
+
+	UPROPERTY()
+	USkeletalMesh* placeholderMesh = NULL;
+};
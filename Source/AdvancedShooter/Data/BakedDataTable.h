@@ -0,0 +1,84 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <Engine/DataTable.h>
+
+/*
+A data table flattened into an array with one row per enum value, so a lookup is an array read
+instead of building an FName and hashing it. Rows are copied out of the table when it is baked.
+The rows of the last bake are kept after a reset so a rebake can be diffed against them.
+*/
+template<typename RowType, typename EnumType>
+class TBakedDataTable
+{
+public:
+	/*
+	Copies the row named rowNames[i] into slot i for every enum value.
+	Names of rows the table doesnt have are added to outMissingRows, returns true when none were missing.
+	*/
+	bool Bake(const UDataTable* table, TArrayView<const FName> rowNames, TArray<FName>& outMissingRows)
+	{
+		Reset();
+
+		if (!table) return false;
+
+		rows.SetNum(rowNames.Num());
+		rowValid.Init(false, rowNames.Num());
+
+		for (int32 i = 0; i < rowNames.Num(); ++i)
+		{
+			const RowType* row = table->FindRow<RowType>(rowNames[i], TEXT(""), false);
+
+			if (!row)
+			{
+				outMissingRows.Add(rowNames[i]);
+				continue;
+			}
+
+			rows[i] = *row;
+			rowValid[i] = true;
+		}
+
+		bBaked = true;
+		return outMissingRows.Num() == 0;
+	}
+
+	void Reset()
+	{
+		if (bBaked)
+		{
+			previousRows = MoveTemp(rows);
+			previousRowValid = MoveTemp(rowValid);
+		}
+
+		rows.Reset();
+		rowValid.Reset();
+		bBaked = false;
+	}
+
+	// NULL when the table had no row for this value
+	const RowType* Get(EnumType value) const
+	{
+		const int32 index = (int32)value;
+		return rowValid.IsValidIndex(index) && rowValid[index] ? &rows[index] : NULL;
+	}
+
+	// The row as it was before the last reset, NULL if it wasnt baked then
+	const RowType* GetPrevious(EnumType value) const
+	{
+		const int32 index = (int32)value;
+		return previousRowValid.IsValidIndex(index) && previousRowValid[index] ? &previousRows[index] : NULL;
+	}
+
+	bool IsBaked() const { return bBaked; }
+
+private:
+	TArray<RowType> rows;
+	TArray<bool> rowValid;
+
+	TArray<RowType> previousRows;
+	TArray<bool> previousRowValid;
+	bool bBaked = false;
+};
@@ -0,0 +1,71 @@
+#include "DataTableHotApplySubsystem.h"
+#include <AdvancedShooter/AdvancedShooter.h>
+#include <AdvancedShooter/Items/Weapon.h>
+#include <AdvancedShooter/AI/Enemy.h>
+#include "EngineUtils.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hot Applied Actors"), STAT_HotAppliedActors, STATGROUP_AdvancedShooter);
+
+bool UDataTableHotApplySubsystem::DoesSupportWorldType(EWorldType::Type worldType) const
+{
+	return worldType == EWorldType::Game || worldType == EWorldType::PIE;
+}
+
+void UDataTableHotApplySubsystem::Initialize(FSubsystemCollectionBase& collection)
+{
+	Super::Initialize(collection);
+
+	UDataTableRegistry* registry = UDataTableRegistry::Get();
+	if (!registry) return;
+
+	tableChangedHandle = registry->OnTableChanged().AddUObject(this, &UDataTableHotApplySubsystem::OnTableChanged);
+}
+
+void UDataTableHotApplySubsystem::Deinitialize()
+{
+	if (UDataTableRegistry* registry = UDataTableRegistry::Get())
+	{
+		registry->OnTableChanged().Remove(tableChangedHandle);
+	}
+	tableChangedHandle.Reset();
+
+	Super::Deinitialize();
+}
+
+void UDataTableHotApplySubsystem::OnTableChanged(EGameDataTable table)
+{
+	UWorld* world = GetWorld();
+	if (!world) return;
+
+	int32 updatedActors = 0;
+
+	switch (table)
+	{
+		case EGameDataTable::EGDT_Weapon:
+			for (TActorIterator<AWeapon> it(world); it; ++it)
+			{
+				if (it->HotApplyWeaponData()) ++updatedActors;
+			}
+			break;
+
+		case EGameDataTable::EGDT_Enemy:
+			for (TActorIterator<AEnemy> it(world); it; ++it)
+			{
+				if (it->HotApplyEnemyData()) ++updatedActors;
+			}
+			break;
+
+		case EGameDataTable::EGDT_EnemyLevel:
+			for (TActorIterator<AEnemy> it(world); it; ++it)
+			{
+				if (it->HotApplyEnemyLevelData()) ++updatedActors;
+			}
+			break;
+
+		default:
+			return;
+	}
+
+	INC_DWORD_STAT_BY(STAT_HotAppliedActors, updatedActors);
+	UE_LOG(LogTemp, Log, TEXT("Hot applied %s table edit to %d actors"), *UEnum::GetValueAsString(table), updatedActors);
+}
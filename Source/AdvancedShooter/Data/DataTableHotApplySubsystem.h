@@ -0,0 +1,31 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include <AdvancedShooter/Data/DataTableRegistry.h>
+#include "DataTableHotApplySubsystem.generated.h"
+
+/*
+Pushes edits to the weapon, enemy and enemy level tables into the weapons and enemies already in the world,
+so tuning during a play session shows up without respawning anything.
+Each actor diffs the rows from before and after the edit and only takes the tuning fields that changed; assets are left alone.
+*/
+UCLASS()
+class ADVANCEDSHOOTER_API UDataTableHotApplySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& collection) override;
+	virtual void Deinitialize() override;
+
+protected:
+	virtual bool DoesSupportWorldType(EWorldType::Type worldType) const override;
+
+private:
+	void OnTableChanged(EGameDataTable table);
+
+	FDelegateHandle tableChangedHandle;
+};
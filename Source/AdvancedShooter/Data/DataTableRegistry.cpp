@@ -0,0 +1,303 @@
+#include "DataTableRegistry.h"
+#include <AdvancedShooter/AdvancedShooter.h>
+#include <Engine/Engine.h>
+#include "UObject/UObjectGlobals.h"
+#include "Misc/CoreDelegates.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Data Table Requests"), STAT_DataTableRequests, STATGROUP_AdvancedShooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Data Table Loads"), STAT_DataTableLoads, STATGROUP_AdvancedShooter);
+
+// Indexed by EGameDataTable
+static const TCHAR* GameDataTablePaths[] =
+{
+	TEXT("DataTable'/Game/_Game/DataTable/DT_Enemy.DT_Enemy'"),
+	TEXT("DataTable'/Game/_Game/DataTable/DT_EnemyLevel.DT_EnemyLevel'"),
+	TEXT("DataTable'/Game/_Game/DataTable/DT_ItemRarity.DT_ItemRarity'"),
+	TEXT("DataTable'/Game/_Game/DataTable/DT_Weapon.DT_Weapon'"),
+};
+static_assert(UE_ARRAY_COUNT(GameDataTablePaths) == (int32)EGameDataTable::EGDT_MAX, "Every EGameDataTable needs a path");
+
+// Row name for each enum value, in enum order
+static TArrayView<const FName> GetRowNames(EGameDataTable table)
+{
+	static const FName EnemyRows[] = { TEXT("Grux"), TEXT("Khaimera") };
+	static_assert(UE_ARRAY_COUNT(EnemyRows) == (int32)EEnemyType::EET_MAX, "Every EEnemyType needs a row name");
+
+	static const FName EnemyLevelRows[] =
+	{
+		TEXT("Level1"), TEXT("Level2"), TEXT("Level3"), TEXT("Level4"), TEXT("Level5"),
+		TEXT("Level6"), TEXT("Level7"), TEXT("Level8"), TEXT("Level9"), TEXT("Level10"),
+	};
+	static_assert(UE_ARRAY_COUNT(EnemyLevelRows) == (int32)EEnemyLevel::EEL_MAX, "Every EEnemyLevel needs a row name");
+
+	static const FName RarityRows[] = { TEXT("Damaged"), TEXT("Common"), TEXT("Uncommon"), TEXT("Rare"), TEXT("Legendary") };
+	static_assert(UE_ARRAY_COUNT(RarityRows) == (int32)EItemRarity::EIR_MAX, "Every EItemRarity needs a row name");
+
+	static const FName WeaponRows[] = { TEXT("SMG"), TEXT("AR"), TEXT("Pistol"), TEXT("Shotgun") };
+	static_assert(UE_ARRAY_COUNT(WeaponRows) == (int32)EWeaponType::EWT_MAX, "Every EWeaponType needs a row name");
+
+	switch (table)
+	{
+		case EGameDataTable::EGDT_Enemy:
+			return EnemyRows;
+
+		case EGameDataTable::EGDT_EnemyLevel:
+			return EnemyLevelRows;
+
+		case EGameDataTable::EGDT_ItemRarity:
+			return RarityRows;
+
+		case EGameDataTable::EGDT_Weapon:
+			return WeaponRows;
+
+		default:
+			return TArrayView<const FName>();
+	}
+}
+
+static FAutoConsoleCommand ValidateDataTablesCommand(
+	TEXT("Shooter.DataTables.Validate"),
+	TEXT("Bakes every game data table and logs any rows that are missing."),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		UDataTableRegistry* registry = UDataTableRegistry::Get();
+		if (!registry) return;
+
+		registry->ValidateTables();
+	}));
+
+void UDataTableRegistry::Initialize(FSubsystemCollectionBase& collection)
+{
+	Super::Initialize(collection);
+
+	tables.SetNumZeroed((int32)EGameDataTable::EGDT_MAX);
+	failedTables.Init(false, (int32)EGameDataTable::EGDT_MAX);
+	tableChangedHandles.SetNum((int32)EGameDataTable::EGDT_MAX);
+
+	preLoadMapHandle = FCoreUObjectDelegates::PreLoadMap.AddUObject(this, &UDataTableRegistry::OnPreLoadMap);
+	postLoadMapHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &UDataTableRegistry::OnPostLoadMap);
+	postEngineInitHandle = FCoreDelegates::OnPostEngineInit.AddUObject(this, &UDataTableRegistry::OnPostEngineInit);
+}
+
+void UDataTableRegistry::Deinitialize()
+{
+	FCoreUObjectDelegates::PreLoadMap.Remove(preLoadMapHandle);
+	FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(postLoadMapHandle);
+	FCoreDelegates::OnPostEngineInit.Remove(postEngineInitHandle);
+
+	for (int32 i = 0; i < tables.Num(); ++i)
+	{
+		InvalidateTable((EGameDataTable)i);
+	}
+
+	Super::Deinitialize();
+}
+
+UDataTableRegistry* UDataTableRegistry::Get()
+{
+	if (!GEngine) return NULL;
+
+	return GEngine->GetEngineSubsystem<UDataTableRegistry>();
+}
+
+UDataTable* UDataTableRegistry::GetTable(EGameDataTable table)
+{
+	const int32 index = (int32)table;
+	if (!tables.IsValidIndex(index)) return NULL;
+
+	++tableRequests;
+	INC_DWORD_STAT(STAT_DataTableRequests);
+
+	if (tables[index]) return tables[index];
+	if (failedTables[index]) return NULL;
+
+	++tableLoads;
+	INC_DWORD_STAT(STAT_DataTableLoads);
+
+	const double loadStart = FPlatformTime::Seconds();
+	UDataTable* dataTable = Cast<UDataTable>(StaticLoadObject(UDataTable::StaticClass(), NULL, GameDataTablePaths[index]));
+	loadSeconds += FPlatformTime::Seconds() - loadStart;
+
+	if (!dataTable)
+	{
+		failedTables[index] = true;
+		UE_LOG(LogTemp, Error, TEXT("Failed to load data table %s"), GameDataTablePaths[index]);
+		return NULL;
+	}
+
+	// Time a lookup of the now loaded table, this is what each actor paid before the cache
+	const double lookupStart = FPlatformTime::Seconds();
+	StaticLoadObject(UDataTable::StaticClass(), NULL, GameDataTablePaths[index]);
+	lookupSeconds = FPlatformTime::Seconds() - lookupStart;
+
+	tables[index] = dataTable;
+	tableChangedHandles[index] = dataTable->OnDataTableChanged().AddUObject(this, &UDataTableRegistry::OnDataTableChanged, table);
+
+	BakeTable(table, dataTable);
+
+	return dataTable;
+}
+
+const FWeaponDataTable* UDataTableRegistry::GetWeaponRow(EWeaponType weaponType)
+{
+	if (!bakedWeapons.IsBaked()) GetTable(EGameDataTable::EGDT_Weapon);
+	return bakedWeapons.Get(weaponType);
+}
+
+const FItemRarityTable* UDataTableRegistry::GetRarityRow(EItemRarity rarity)
+{
+	if (!bakedRarities.IsBaked()) GetTable(EGameDataTable::EGDT_ItemRarity);
+	return bakedRarities.Get(rarity);
+}
+
+const FEnemyDataTable* UDataTableRegistry::GetEnemyRow(EEnemyType enemyType)
+{
+	if (!bakedEnemies.IsBaked()) GetTable(EGameDataTable::EGDT_Enemy);
+	return bakedEnemies.Get(enemyType);
+}
+
+const FEnemyLevelDataTable* UDataTableRegistry::GetEnemyLevelRow(EEnemyLevel enemyLevel)
+{
+	if (!bakedEnemyLevels.IsBaked()) GetTable(EGameDataTable::EGDT_EnemyLevel);
+	return bakedEnemyLevels.Get(enemyLevel);
+}
+
+bool UDataTableRegistry::BakeTable(EGameDataTable table, const UDataTable* dataTable)
+{
+	const TArrayView<const FName> rowNames = GetRowNames(table);
+	TArray<FName> missingRows;
+	bool bComplete = false;
+
+	switch (table)
+	{
+		case EGameDataTable::EGDT_Enemy:
+			bComplete = bakedEnemies.Bake(dataTable, rowNames, missingRows);
+			break;
+
+		case EGameDataTable::EGDT_EnemyLevel:
+			bComplete = bakedEnemyLevels.Bake(dataTable, rowNames, missingRows);
+			break;
+
+		case EGameDataTable::EGDT_ItemRarity:
+			bComplete = bakedRarities.Bake(dataTable, rowNames, missingRows);
+			break;
+
+		case EGameDataTable::EGDT_Weapon:
+			bComplete = bakedWeapons.Bake(dataTable, rowNames, missingRows);
+			break;
+
+		default:
+			break;
+	}
+
+	for (const FName& rowName : missingRows)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Data table %s is missing row %s"), *GetNameSafe(dataTable), *rowName.ToString());
+	}
+
+	return bComplete;
+}
+
+void UDataTableRegistry::ResetBakedTable(EGameDataTable table)
+{
+	switch (table)
+	{
+		case EGameDataTable::EGDT_Enemy:
+			bakedEnemies.Reset();
+			break;
+
+		case EGameDataTable::EGDT_EnemyLevel:
+			bakedEnemyLevels.Reset();
+			break;
+
+		case EGameDataTable::EGDT_ItemRarity:
+			bakedRarities.Reset();
+			break;
+
+		case EGameDataTable::EGDT_Weapon:
+			bakedWeapons.Reset();
+			break;
+
+		default:
+			break;
+	}
+}
+
+bool UDataTableRegistry::ValidateTables()
+{
+	bool bValid = true;
+
+	for (int32 i = 0; i < (int32)EGameDataTable::EGDT_MAX; ++i)
+	{
+		const EGameDataTable table = (EGameDataTable)i;
+
+		// Run by hand or by the cook, so a table that failed earlier gets another try
+		if (failedTables[i]) InvalidateTable(table);
+
+		UDataTable* dataTable = GetTable(table);
+
+		if (!dataTable)
+		{
+			bValid = false;
+			continue;
+		}
+
+		// Bake again rather than trusting an earlier bake, so every missing row is logged
+		bValid &= BakeTable(table, dataTable);
+	}
+
+	return bValid;
+}
+
+void UDataTableRegistry::OnPostEngineInit()
+{
+	if (!IsRunningCommandlet()) return;
+
+	if (ValidateTables()) return;
+	UE_LOG(LogTemp, Error, TEXT("Game data tables are missing rows, see the errors above"));
+}
+
+void UDataTableRegistry::InvalidateTable(EGameDataTable table)
+{
+	const int32 index = (int32)table;
+	if (!tables.IsValidIndex(index)) return;
+
+	failedTables[index] = false;
+	if (!tables[index]) return;
+
+	tables[index]->OnDataTableChanged().Remove(tableChangedHandles[index]);
+	tableChangedHandles[index].Reset();
+	tables[index] = NULL;
+
+	ResetBakedTable(table);
+}
+
+void UDataTableRegistry::OnDataTableChanged(EGameDataTable table)
+{
+	// Reimported or edited, rows may have moved so nothing from the old table can be trusted
+	InvalidateTable(table);
+
+	onTableChanged.Broadcast(table);
+}
+
+void UDataTableRegistry::OnPreLoadMap(const FString& mapName)
+{
+	tableRequests = 0;
+	tableLoads = 0;
+	loadSeconds = 0.0;
+}
+
+void UDataTableRegistry::OnPostLoadMap(UWorld* world)
+{
+	LogLoadStats();
+}
+
+void UDataTableRegistry::LogLoadStats() const
+{
+	const int32 cachedRequests = tableRequests - tableLoads;
+	const double savedSeconds = cachedRequests * lookupSeconds;
+
+	UE_LOG(LogTemp, Log, TEXT("Data tables: %d requests, %d loads in %.2f ms, %d served from cache saving about %.2f ms"),
+		tableRequests, tableLoads, loadSeconds * 1000.0, cachedRequests, savedSeconds * 1000.0);
+}
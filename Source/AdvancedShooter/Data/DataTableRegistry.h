@@ -0,0 +1,121 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/EngineSubsystem.h"
+#include <Engine/DataTable.h>
+#include <AdvancedShooter/Data/BakedDataTable.h>
+#include <AdvancedShooter/Items/Weapon.h>
+#include <AdvancedShooter/AI/Enemy.h>
+#include "DataTableRegistry.generated.h"
+
+// The data tables the game reads actor setup from
+UENUM()
+enum class EGameDataTable : uint8
+{
+	EGDT_Enemy UMETA(DisplayName = "Enemy"),
+	EGDT_EnemyLevel UMETA(DisplayName = "Enemy Level"),
+	EGDT_ItemRarity UMETA(DisplayName = "Item Rarity"),
+	EGDT_Weapon UMETA(DisplayName = "Weapon"),
+
+	EGDT_MAX UMETA(DisplayName = "Default Max"),
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnGameDataTableChanged, EGameDataTable);
+
+/*
+Loads each game data table once and hands out rows from the cached table, instead of every actor
+calling StaticLoadObject on a hard coded path from OnConstruction.
+Tables are baked into arrays indexed by their enum when loaded, and checked for missing rows when running a commandlet such as the cook.
+Lives on the engine so placed actors in the editor share the same cache as the game.
+*/
+UCLASS()
+class ADVANCEDSHOOTER_API UDataTableRegistry : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& collection) override;
+	virtual void Deinitialize() override;
+
+	// NULL before the engine is up, eg for class default objects
+	static UDataTableRegistry* Get();
+
+	// Loads the table the first time it is asked for, a table that failed to load stays NULL until it is invalidated
+	UDataTable* GetTable(EGameDataTable table);
+
+	template<typename RowType>
+	RowType* FindRow(EGameDataTable table, FName rowName)
+	{
+		UDataTable* dataTable = GetTable(table);
+		if (!dataTable) return NULL;
+
+		return dataTable->FindRow<RowType>(rowName, TEXT(""));
+	}
+
+	// Baked rows, NULL when the table is missing the row
+	const FWeaponDataTable* GetWeaponRow(EWeaponType weaponType);
+	const FItemRarityTable* GetRarityRow(EItemRarity rarity);
+	const FEnemyDataTable* GetEnemyRow(EEnemyType enemyType);
+	const FEnemyLevelDataTable* GetEnemyLevelRow(EEnemyLevel enemyLevel);
+
+	// Rows from before the table last changed, for diffing against the current ones
+	const FWeaponDataTable* GetPreviousWeaponRow(EWeaponType weaponType) const { return bakedWeapons.GetPrevious(weaponType); }
+	const FEnemyDataTable* GetPreviousEnemyRow(EEnemyType enemyType) const { return bakedEnemies.GetPrevious(enemyType); }
+	const FEnemyLevelDataTable* GetPreviousEnemyLevelRow(EEnemyLevel enemyLevel) const { return bakedEnemyLevels.GetPrevious(enemyLevel); }
+
+	// Bakes every table and logs an error for each missing row, false if anything was missing. Retries tables that failed to load
+	bool ValidateTables();
+
+	// Drops the cached table or load failure so the next request loads it again
+	void InvalidateTable(EGameDataTable table);
+
+	// Broadcast when a table is reimported or edited
+	FOnGameDataTableChanged& OnTableChanged() { return onTableChanged; }
+
+	// Writes load time and the time saved by the cache since the last map load
+	void LogLoadStats() const;
+
+private:
+	// Flattens a loaded table into its baked array, false when a row is missing
+	bool BakeTable(EGameDataTable table, const UDataTable* dataTable);
+
+	void ResetBakedTable(EGameDataTable table);
+
+	void OnDataTableChanged(EGameDataTable table);
+
+	// Validates the tables when cooking so missing rows fail the cook instead of showing up in game
+	void OnPostEngineInit();
+
+	void OnPreLoadMap(const FString& mapName);
+	void OnPostLoadMap(UWorld* world);
+
+	UPROPERTY()
+	TArray<UDataTable*> tables;
+
+	// Tables that failed to load, so per shot and per tick lookups dont request and log them again
+	TArray<bool> failedTables;
+
+	TArray<FDelegateHandle> tableChangedHandles;
+
+	FOnGameDataTableChanged onTableChanged;
+
+	TBakedDataTable<FEnemyDataTable, EEnemyType> bakedEnemies;
+	TBakedDataTable<FEnemyLevelDataTable, EEnemyLevel> bakedEnemyLevels;
+	TBakedDataTable<FItemRarityTable, EItemRarity> bakedRarities;
+	TBakedDataTable<FWeaponDataTable, EWeaponType> bakedWeapons;
+
+	FDelegateHandle postEngineInitHandle;
+
+	FDelegateHandle preLoadMapHandle;
+	FDelegateHandle postLoadMapHandle;
+
+	// LOAD STATS, reset when a map starts loading
+	int32 tableRequests = 0;
+	int32 tableLoads = 0;
+	double loadSeconds = 0.0;
+
+	// Cost of one StaticLoadObject call on an already loaded table, what every actor used to pay
+	double lookupSeconds = 0.0;
+};
@@ -0,0 +1,178 @@
+#include "DamageNumberComponent.h"
+#include <AdvancedShooter/AdvancedShooter.h>
+#include <AdvancedShooter/Effects/DamageNumberWidget.h>
+#include <AdvancedShooter/ShooterPlayerController.h>
+#include "Engine/LocalPlayer.h"
+#include "Engine/GameViewportClient.h"
+#include "Engine/World.h"
+#include "SceneView.h"
+
+DECLARE_CYCLE_STAT(TEXT("Damage Number Update"), STAT_DamageNumberUpdate, STATGROUP_AdvancedShooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Damage Numbers On Screen"), STAT_DamageNumbersOnScreen, STATGROUP_AdvancedShooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damage Numbers Reused Early"), STAT_DamageNumbersReusedEarly, STATGROUP_AdvancedShooter);
+
+// Sets default values for this component's properties
+UDamageNumberComponent::UDamageNumberComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+
+	// Follow the camera the frame has ended up with
+	PrimaryComponentTick.TickGroup = TG_PostUpdateWork;
+}
+
+// Called when the game starts
+void UDamageNumberComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	CreateWidgets();
+}
+
+void UDamageNumberComponent::EndPlay(const EEndPlayReason::Type endPlayReason)
+{
+	DEC_DWORD_STAT_BY(STAT_DamageNumbersOnScreen, numbers.Num());
+	numbers.Empty();
+
+	for (UDamageNumberWidget* widget : widgets)
+	{
+		if (widget) widget->RemoveFromParent();
+	}
+
+	widgets.Empty();
+	freeWidgets.Empty();
+
+	Super::EndPlay(endPlayReason);
+}
+
+void UDamageNumberComponent::CreateWidgets()
+{
+	APlayerController* playerController = Cast<APlayerController>(GetOwner());
+	if (!playerController || !playerController->IsLocalPlayerController() || !damageNumberClass) return;
+
+	widgets.Reserve(poolSize);
+	freeWidgets.Reserve(poolSize);
+	numbers.Reserve(poolSize);
+
+	for (int32 i = 0; i < poolSize; ++i)
+	{
+		UDamageNumberWidget* widget = CreateWidget<UDamageNumberWidget>(playerController, damageNumberClass);
+		if (!widget) continue;
+
+		widget->AddToViewport();
+		widget->SetVisibility(ESlateVisibility::Collapsed);
+
+		freeWidgets.Add(widgets.Add(widget));
+	}
+}
+
+void UDamageNumberComponent::AddDamageNumber(int32 damage, const FVector& location, bool bIsHeadShot)
+{
+	if (widgets.Num() == 0) return;
+
+	if (freeWidgets.Num() == 0)
+	{
+		INC_DWORD_STAT(STAT_DamageNumbersReusedEarly);
+		RemoveOldest(1);
+	}
+
+	FDamageNumber& number = numbers.AddDefaulted_GetRef();
+	number.worldLocation = location;
+	number.spawnTime = GetWorld()->GetTimeSeconds();
+	number.damage = damage;
+	number.bIsHeadShot = bIsHeadShot;
+	number.widgetIndex = freeWidgets.Pop(false);
+
+	INC_DWORD_STAT(STAT_DamageNumbersOnScreen);
+
+	// Stays collapsed until ProjectNumbers places it, otherwise it flashes wherever it was last shown
+	widgets[number.widgetIndex]->OnShowDamage(damage, bIsHeadShot);
+
+	SetComponentTickEnabled(true);
+}
+
+void UDamageNumberComponent::ShowDamageNumber(const UObject* worldContext, AController* instigator, int32 damage, const FVector& location, bool bIsHeadShot)
+{
+	AShooterPlayerController* playerController = Cast<AShooterPlayerController>(instigator);
+
+	if (!playerController)
+	{
+		const UWorld* world = worldContext ? worldContext->GetWorld() : NULL;
+		playerController = world ? Cast<AShooterPlayerController>(world->GetFirstPlayerController()) : NULL;
+	}
+
+	if (!playerController || !playerController->GetDamageNumbers()) return;
+	playerController->GetDamageNumbers()->AddDamageNumber(damage, location, bIsHeadShot);
+}
+
+void UDamageNumberComponent::RemoveOldest(int32 count)
+{
+	count = FMath::Min(count, numbers.Num());
+	if (count <= 0) return;
+
+	for (int32 i = 0; i < count; ++i)
+	{
+		const int32 widgetIndex = numbers[i].widgetIndex;
+		widgets[widgetIndex]->SetVisibility(ESlateVisibility::Collapsed);
+		freeWidgets.Add(widgetIndex);
+	}
+
+	numbers.RemoveAt(0, count, false);
+	DEC_DWORD_STAT_BY(STAT_DamageNumbersOnScreen, count);
+}
+
+void UDamageNumberComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	SCOPE_CYCLE_COUNTER(STAT_DamageNumberUpdate);
+
+	// Every number lives as long, so the expired ones are always at the front
+	const float expireTime = GetWorld()->GetTimeSeconds() - lifetime;
+
+	int32 expiredCount = 0;
+	while (expiredCount < numbers.Num() && numbers[expiredCount].spawnTime <= expireTime)
+	{
+		++expiredCount;
+	}
+
+	RemoveOldest(expiredCount);
+
+	if (numbers.Num() == 0)
+	{
+		SetComponentTickEnabled(false);
+		return;
+	}
+
+	ProjectNumbers();
+}
+
+void UDamageNumberComponent::ProjectNumbers()
+{
+	const APlayerController* playerController = Cast<APlayerController>(GetOwner());
+	const ULocalPlayer* localPlayer = playerController ? playerController->GetLocalPlayer() : NULL;
+	if (!localPlayer || !localPlayer->ViewportClient) return;
+
+	// Same projection UGameplayStatics::ProjectWorldToScreen builds, once for every number
+	FSceneViewProjectionData projectionData;
+	if (!localPlayer->GetProjectionData(localPlayer->ViewportClient->Viewport, projectionData)) return;
+
+	const FMatrix viewProjection = projectionData.ComputeViewProjectionMatrix();
+	const FIntRect viewRect = projectionData.GetConstrainedViewRect();
+
+	for (const FDamageNumber& number : numbers)
+	{
+		UDamageNumberWidget* widget = widgets[number.widgetIndex];
+
+		FVector2D screenPosition;
+		if (!FSceneView::ProjectWorldToScreen(number.worldLocation, viewRect, viewProjection, screenPosition))
+		{
+			// Behind the camera
+			widget->SetVisibility(ESlateVisibility::Collapsed);
+			continue;
+		}
+
+		widget->SetVisibility(ESlateVisibility::HitTestInvisible);
+		widget->SetPositionInViewport(screenPosition);
+	}
+}
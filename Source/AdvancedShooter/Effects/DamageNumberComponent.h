@@ -0,0 +1,85 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "DamageNumberComponent.generated.h"
+
+class AController;
+class UDamageNumberWidget;
+
+// One number on screen
+struct FDamageNumber
+{
+	FVector worldLocation = FVector::ZeroVector;
+
+	// World time it was shown, numbers expire lifetime seconds later
+	float spawnTime = 0.f;
+
+	int32 damage = 0;
+	bool bIsHeadShot = false;
+
+	// Index of the widget showing it
+	int32 widgetIndex = INDEX_NONE;
+};
+
+/*
+Shows every damage number for its player controller from a fixed pool of widgets that are added to the
+viewport once. Live numbers are kept oldest first in one array, so expiring them is trimming the front,
+and the whole array is projected each tick with the view projection matrix built once.
+Only ticks while numbers are on screen.
+*/
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class ADVANCEDSHOOTER_API UDamageNumberComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	// Sets default values for this component's properties
+	UDamageNumberComponent();
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	// Takes a widget from the pool, reusing the oldest number when every widget is showing
+	void AddDamageNumber(int32 damage, const FVector& location, bool bIsHeadShot);
+
+	// Shows the number to the instigating player, or the first player when the instigator isnt one
+	static void ShowDamageNumber(const UObject* worldContext, AController* instigator, int32 damage, const FVector& location, bool bIsHeadShot);
+
+	FORCEINLINE int32 GetNumDamageNumbers() const { return numbers.Num(); }
+
+protected:
+	// Called when the game starts
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type endPlayReason) override;
+
+private:
+	void CreateWidgets();
+
+	// Hides the oldest count numbers and frees their widgets
+	void RemoveOldest(int32 count);
+
+	// Moves every live number to where its world location is on screen
+	void ProjectNumbers();
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Damage Numbers", meta = (AllowPrivateAccess = "true"))
+	TSubclassOf<UDamageNumberWidget> damageNumberClass;
+
+	// Most numbers on screen at once
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Damage Numbers", meta = (AllowPrivateAccess = "true"))
+	int32 poolSize = 32;
+
+	// Seconds a number stays on screen
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Damage Numbers", meta = (AllowPrivateAccess = "true"))
+	float lifetime = 1.5f;
+
+	UPROPERTY(Transient)
+	TArray<UDamageNumberWidget*> widgets;
+
+	// Indices of widgets not showing a number
+	TArray<int32> freeWidgets;
+
+	// Oldest first
+	TArray<FDamageNumber> numbers;
+};
@@ -0,0 +1,22 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "DamageNumberWidget.generated.h"
+
+/*
+Base for the floating damage number. Instances are pooled by UDamageNumberComponent and stay in the
+viewport, so OnShowDamage should restart any animation rather than expect a freshly created widget.
+*/
+UCLASS(Abstract)
+class ADVANCEDSHOOTER_API UDamageNumberWidget : public UUserWidget
+{
+	GENERATED_BODY()
+
+public:
+	// Called each time the widget is taken from the pool for a new number
+	UFUNCTION(BlueprintImplementableEvent, Category = "Damage Number")
+	void OnShowDamage(int32 damage, bool bIsHeadShot);
+};
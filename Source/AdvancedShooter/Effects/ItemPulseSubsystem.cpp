@@ -0,0 +1,127 @@
+#include "ItemPulseSubsystem.h"
+#include <AdvancedShooter/AdvancedShooter.h>
+#include <AdvancedShooter/Items/Item.h>
+#include <Curves/CurveVector.h>
+#include "Materials/MaterialInstanceDynamic.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("Item Pulse Update"), STAT_ItemPulseUpdate, STATGROUP_AdvancedShooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pulsing Items"), STAT_PulsingItems, STATGROUP_AdvancedShooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pulse Curve Samples"), STAT_PulseCurveSamples, STATGROUP_AdvancedShooter);
+
+static const FName GlowAmountName(TEXT("GlowAmount"));
+static const FName FresnelExponentName(TEXT("FresnelExponent"));
+static const FName FresnelReflectFractionName(TEXT("FresnelReflectFraction"));
+
+bool UItemPulseSubsystem::DoesSupportWorldType(EWorldType::Type worldType) const
+{
+	return worldType == EWorldType::Game || worldType == EWorldType::PIE;
+}
+
+void UItemPulseSubsystem::Deinitialize()
+{
+	pulses.Empty();
+	itemToIndex.Empty();
+	curveSamples.Empty();
+
+	Super::Deinitialize();
+}
+
+TStatId UItemPulseSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UItemPulseSubsystem, STATGROUP_Tickables);
+}
+
+void UItemPulseSubsystem::AddPulse(AItem* item, const UCurveVector* curve, float period, const FVector& parameterScale)
+{
+	if (!item || !curve) return;
+
+	const FObjectKey itemKey(item);
+	const int32* existingIndex = itemToIndex.Find(itemKey);
+
+	FItemPulse& pulse = existingIndex ? pulses[*existingIndex] : pulses.AddDefaulted_GetRef();
+	if (!existingIndex) itemToIndex.Add(itemKey, pulses.Num() - 1);
+
+	pulse.item = item;
+	pulse.itemKey = itemKey;
+	pulse.curve = curve;
+	pulse.startTime = GetWorld()->GetTimeSeconds();
+	pulse.period = period;
+	pulse.parameterScale = parameterScale;
+}
+
+void UItemPulseSubsystem::RemovePulse(AItem* item)
+{
+	const int32* index = itemToIndex.Find(FObjectKey(item));
+	if (!index) return;
+
+	RemoveAtSwap(*index);
+
+	// Not pulsing means no glow, same as the curve at zero
+	SetPulseParameters(item, FVector::ZeroVector);
+}
+
+void UItemPulseSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ItemPulseUpdate);
+
+	const float worldTime = GetWorld()->GetTimeSeconds();
+
+	curveSamples.Reset();
+
+	// Backwards so removing destroyed items doesnt skip any
+	for (int32 i = pulses.Num() - 1; i >= 0; --i)
+	{
+		const FItemPulse& pulse = pulses[i];
+
+		AItem* item = pulse.item.Get();
+		if (!item)
+		{
+			RemoveAtSwap(i);
+			continue;
+		}
+
+		float elapsedTime = worldTime - pulse.startTime;
+		if (pulse.period > 0.f) elapsedTime = FMath::Fmod(elapsedTime, pulse.period);
+
+		const TPair<const UCurveVector*, int32> sampleKey(pulse.curve, FMath::RoundToInt(elapsedTime * 1000.f));
+		const FVector* curveValue = curveSamples.Find(sampleKey);
+
+		if (!curveValue)
+		{
+			curveValue = &curveSamples.Add(sampleKey, pulse.curve->GetVectorValue(elapsedTime));
+			INC_DWORD_STAT(STAT_PulseCurveSamples);
+		}
+
+		SetPulseParameters(item, *curveValue * pulse.parameterScale);
+	}
+
+	SET_DWORD_STAT(STAT_PulsingItems, pulses.Num());
+}
+
+void UItemPulseSubsystem::SetPulseParameters(AItem* item, const FVector& parameters)
+{
+	UMaterialInstanceDynamic* material = item ? item->GetDynamicMaterialInstance() : NULL;
+	if (!material) return;
+
+	material->SetScalarParameterValue(GlowAmountName, parameters.X);
+	material->SetScalarParameterValue(FresnelExponentName, parameters.Y);
+	material->SetScalarParameterValue(FresnelReflectFractionName, parameters.Z);
+}
+
+void UItemPulseSubsystem::RemoveAtSwap(int32 index)
+{
+	if (!pulses.IsValidIndex(index)) return;
+
+	const int32 lastIndex = pulses.Num() - 1;
+
+	itemToIndex.Remove(pulses[index].itemKey);
+
+	// Last pulse moves into the freed slot
+	if (index != lastIndex)
+	{
+		itemToIndex.Add(pulses[lastIndex].itemKey, index);
+	}
+
+	pulses.RemoveAtSwap(index, 1, false);
+}
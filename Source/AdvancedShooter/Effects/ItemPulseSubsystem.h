@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "ItemPulseSubsystem.generated.h"
+
+class AItem;
+class UCurveVector;
+
+// One item whose glow is driven by a pulse curve
+struct FItemPulse
+{
+	TWeakObjectPtr<AItem> item;
+
+	// Still valid once the item is destroyed, for removing it from the index
+	FObjectKey itemKey;
+
+	const UCurveVector* curve = NULL;
+
+	// World time the curve started playing
+	float startTime = 0.f;
+
+	// Curve loops after this many seconds, 0 plays it once and holds the last value
+	float period = 0.f;
+
+	// Multipliers on the curves X, Y and Z for glow amount, fresnel exponent and fresnel reflect fraction
+	FVector parameterScale = FVector::OneVector;
+};
+
+/*
+Drives the glow pulse of every pulsing item from one tick instead of each item ticking to update its own material.
+Items are kept in one array, the curve is sampled once per distinct curve and phase, and the material
+parameters are pushed in a single pass. Items that started pulsing on the same frame share one sample.
+*/
+UCLASS()
+class ADVANCEDSHOOTER_API UItemPulseSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Starts or restarts the items pulse from the beginning of the curve
+	void AddPulse(AItem* item, const UCurveVector* curve, float period, const FVector& parameterScale);
+
+	// Stops the pulse and clears the glow parameters
+	void RemovePulse(AItem* item);
+
+	int32 GetNumPulses() const { return pulses.Num(); }
+
+protected:
+	virtual bool DoesSupportWorldType(EWorldType::Type worldType) const override;
+
+private:
+	void RemoveAtSwap(int32 index);
+
+	static void SetPulseParameters(AItem* item, const FVector& parameters);
+
+	TArray<FItemPulse> pulses;
+
+	// Item to its index in pulses
+	TMap<FObjectKey, int32> itemToIndex;
+
+	// Curve values sampled this tick, keyed by curve and phase in milliseconds
+	TMap<TPair<const UCurveVector*, int32>, FVector> curveSamples;
+};
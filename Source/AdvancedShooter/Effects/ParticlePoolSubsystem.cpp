@@ -0,0 +1,232 @@
+#include "ParticlePoolSubsystem.h"
+#include <AdvancedShooter/AdvancedShooter.h>
+#include <Kismet/GameplayStatics.h>
+#include "Particles/ParticleSystem.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Particle Pool Hits"), STAT_ParticlePoolHits, STATGROUP_AdvancedShooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Particle Pool Misses"), STAT_ParticlePoolMisses, STATGROUP_AdvancedShooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Particle Pool Components"), STAT_ParticlePoolComponents, STATGROUP_AdvancedShooter);
+
+static FAutoConsoleCommandWithWorld DumpParticlePoolsCommand(
+	TEXT("Shooter.ParticlePool.Dump"),
+	TEXT("Logs hits, misses and peak usage for every particle pool in the world."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* world)
+	{
+		if (!world) return;
+
+		const UParticlePoolSubsystem* particlePool = world->GetSubsystem<UParticlePoolSubsystem>();
+		if (!particlePool) return;
+
+		particlePool->LogPoolStats();
+	}));
+
+bool UParticlePoolSubsystem::DoesSupportWorldType(EWorldType::Type worldType) const
+{
+	return worldType == EWorldType::Game || worldType == EWorldType::PIE;
+}
+
+void UParticlePoolSubsystem::Deinitialize()
+{
+	LogPoolStats();
+
+	for (TPair<UParticleSystem*, FParticlePool>& poolPair : pools)
+	{
+		for (UParticleSystemComponent* component : poolPair.Value.freeComponents)
+		{
+			if (component) component->DestroyComponent();
+		}
+
+		for (UParticleSystemComponent* component : poolPair.Value.activeComponents)
+		{
+			if (component) component->DestroyComponent();
+		}
+	}
+	pools.Empty();
+
+	Super::Deinitialize();
+}
+
+UParticleSystemComponent* UParticlePoolSubsystem::SpawnPooledEmitter(const UObject* worldContext, UParticleSystem* system, const FTransform& transform)
+{
+	if (!worldContext || !system) return NULL;
+
+	UWorld* world = worldContext->GetWorld();
+	if (!world) return NULL;
+
+	UParticlePoolSubsystem* particlePool = world->GetSubsystem<UParticlePoolSubsystem>();
+
+	if (!particlePool)
+		return UGameplayStatics::SpawnEmitterAtLocation(world, system, transform);
+
+	return particlePool->SpawnEmitter(system, transform);
+}
+
+UParticleSystemComponent* UParticlePoolSubsystem::SpawnPooledEmitter(const UObject* worldContext, UParticleSystem* system, const FVector& location, const FRotator& rotation)
+{
+	return SpawnPooledEmitter(worldContext, system, FTransform(rotation, location));
+}
+
+UParticleSystemComponent* UParticlePoolSubsystem::SpawnEmitter(UParticleSystem* system, const FTransform& transform)
+{
+	if (!system) return NULL;
+
+	FParticlePool& pool = GetOrCreatePool(system);
+	UParticleSystemComponent* component = NULL;
+
+	if (pool.freeComponents.Num() > 0)
+	{
+		INC_DWORD_STAT(STAT_ParticlePoolHits);
+		++pool.stats.hits;
+
+		component = pool.freeComponents.Pop(false);
+	}
+
+	else
+	{
+		INC_DWORD_STAT(STAT_ParticlePoolMisses);
+		++pool.stats.misses;
+
+		component = HandleExhaustedPool(pool, system);
+	}
+
+	if (!component) return NULL;
+
+	pool.activeComponents.Add(component);
+	pool.stats.peakActive = FMath::Max(pool.stats.peakActive, pool.activeComponents.Num());
+
+	component->SetWorldTransform(transform);
+	component->ActivateSystem(true);
+
+	return component;
+}
+
+UParticleSystemComponent* UParticlePoolSubsystem::HandleExhaustedPool(FParticlePool& pool, UParticleSystem* system)
+{
+	const int32 poolSize = pool.freeComponents.Num() + pool.activeComponents.Num();
+
+	switch (exhaustedPolicy)
+	{
+		case EParticlePoolPolicy::EPP_Drop:
+			++pool.stats.drops;
+			return NULL;
+
+		case EParticlePoolPolicy::EPP_Grow:
+			if (poolSize < maxPoolSize)
+			{
+				++pool.stats.grows;
+				return CreatePooledComponent(system);
+			}
+			// Hit the cap, steal instead
+			break;
+
+		default:
+			break;
+	}
+
+	if (pool.activeComponents.Num() == 0) return NULL;
+
+	++pool.stats.steals;
+
+	// Remove before deactivating so the finished callback doesnt put it back in the free list
+	UParticleSystemComponent* oldest = pool.activeComponents[0];
+	pool.activeComponents.RemoveAt(0, 1, false);
+
+	if (oldest)
+	{
+		oldest->DeactivateImmediate();
+	}
+
+	return oldest;
+}
+
+void UParticlePoolSubsystem::PrewarmPool(UParticleSystem* system, int32 count)
+{
+	if (!system) return;
+
+	FParticlePool& pool = GetOrCreatePool(system);
+
+	const int32 poolSize = pool.freeComponents.Num() + pool.activeComponents.Num();
+	const int32 toCreate = FMath::Min(count, maxPoolSize) - poolSize;
+
+	for (int32 i = 0; i < toCreate; ++i)
+	{
+		UParticleSystemComponent* component = CreatePooledComponent(system);
+		if (!component) break;
+
+		pool.freeComponents.Add(component);
+	}
+}
+
+FParticlePool& UParticlePoolSubsystem::GetOrCreatePool(UParticleSystem* system)
+{
+	FParticlePool* existingPool = pools.Find(system);
+	if (existingPool) return *existingPool;
+
+	FParticlePool& pool = pools.Add(system);
+
+	for (int32 i = 0; i < defaultPoolSize; ++i)
+	{
+		UParticleSystemComponent* component = CreatePooledComponent(system);
+		if (!component) break;
+
+		pool.freeComponents.Add(component);
+	}
+
+	return pool;
+}
+
+UParticleSystemComponent* UParticlePoolSubsystem::CreatePooledComponent(UParticleSystem* system)
+{
+	UWorld* world = GetWorld();
+	if (!world) return NULL;
+
+	UParticleSystemComponent* component = NewObject<UParticleSystemComponent>(world);
+	if (!component) return NULL;
+
+	component->bAutoDestroy = false;
+	component->bAutoActivate = false;
+	component->SetTemplate(system);
+	component->SetAbsolute(true, true, true);
+	component->OnSystemFinished.AddDynamic(this, &UParticlePoolSubsystem::OnComponentFinished);
+	component->RegisterComponentWithWorld(world);
+
+	INC_DWORD_STAT(STAT_ParticlePoolComponents);
+
+	return component;
+}
+
+void UParticlePoolSubsystem::OnComponentFinished(UParticleSystemComponent* component)
+{
+	if (!component) return;
+
+	FParticlePool* pool = pools.Find(component->Template);
+	if (!pool) return;
+
+	// Stolen components were already taken out of the active list
+	if (pool->activeComponents.RemoveSingle(component) > 0)
+	{
+		pool->freeComponents.Add(component);
+	}
+}
+
+FParticlePoolStats UParticlePoolSubsystem::GetPoolStats(UParticleSystem* system) const
+{
+	const FParticlePool* pool = pools.Find(system);
+	return pool ? pool->stats : FParticlePoolStats();
+}
+
+void UParticlePoolSubsystem::LogPoolStats() const
+{
+	for (const TPair<UParticleSystem*, FParticlePool>& poolPair : pools)
+	{
+		const FParticlePoolStats& stats = poolPair.Value.stats;
+
+		UE_LOG(LogTemp, Log, TEXT("Particle pool %s: size %d, hits %d, misses %d (stolen %d, dropped %d, grown %d), peak %d"),
+			*GetNameSafe(poolPair.Key),
+			poolPair.Value.freeComponents.Num() + poolPair.Value.activeComponents.Num(),
+			stats.hits, stats.misses, stats.steals, stats.drops, stats.grows, stats.peakActive);
+	}
+}
@@ -0,0 +1,121 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ParticlePoolSubsystem.generated.h"
+
+class UParticleSystem;
+class UParticleSystemComponent;
+
+// What to do when every component in a pool is playing
+UENUM(BlueprintType)
+enum class EParticlePoolPolicy : uint8
+{
+	EPP_StealOldest UMETA(DisplayName = "Steal Oldest"),
+	EPP_Drop UMETA(DisplayName = "Drop"),
+	EPP_Grow UMETA(DisplayName = "Grow"),
+
+	EPP_MAX UMETA(DisplayName = "Default Max"),
+};
+
+USTRUCT(BlueprintType)
+struct FParticlePoolStats
+{
+	GENERATED_BODY()
+
+	// Spawns served by a free component
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 hits = 0;
+
+	// Spawns that found the pool exhausted
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 misses = 0;
+
+	// Misses handled by stealing, dropping or growing
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 steals = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 drops = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 grows = 0;
+
+	// Most components playing at once
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 peakActive = 0;
+};
+
+USTRUCT()
+struct FParticlePool
+{
+	GENERATED_BODY()
+
+	// Components ready to be played
+	UPROPERTY()
+	TArray<UParticleSystemComponent*> freeComponents;
+
+	// Playing components, oldest first
+	UPROPERTY()
+	TArray<UParticleSystemComponent*> activeComponents;
+
+	FParticlePoolStats stats;
+};
+
+/*
+Keeps a pre-warmed pool of particle components per particle system and recycles them when they finish,
+instead of creating and registering a new component for every muzzle flash, trail and impact.
+Pool size and exhausted policy are set in the [/Script/AdvancedShooter.ParticlePoolSubsystem] section of DefaultGame.ini.
+*/
+UCLASS(Config = Game)
+class ADVANCEDSHOOTER_API UParticlePoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	// Plays a pooled emitter, may return NULL when the pool is exhausted and the policy is drop
+	UParticleSystemComponent* SpawnEmitter(UParticleSystem* system, const FTransform& transform);
+
+	// Spawns through the worlds pool, falls back to a normal emitter when there is no pool (editor worlds)
+	static UParticleSystemComponent* SpawnPooledEmitter(const UObject* worldContext, UParticleSystem* system, const FTransform& transform);
+	static UParticleSystemComponent* SpawnPooledEmitter(const UObject* worldContext, UParticleSystem* system, const FVector& location, const FRotator& rotation = FRotator::ZeroRotator);
+
+	// Creates components up front so the first shots dont pay for them
+	void PrewarmPool(UParticleSystem* system, int32 count);
+
+	FParticlePoolStats GetPoolStats(UParticleSystem* system) const;
+
+	// Writes the stats for every pool to the log
+	void LogPoolStats() const;
+
+protected:
+	virtual bool DoesSupportWorldType(EWorldType::Type worldType) const override;
+
+	UFUNCTION()
+	void OnComponentFinished(UParticleSystemComponent* component);
+
+private:
+	FParticlePool& GetOrCreatePool(UParticleSystem* system);
+	UParticleSystemComponent* CreatePooledComponent(UParticleSystem* system);
+
+	// Component to play when the pool is exhausted, based on exhaustedPolicy
+	UParticleSystemComponent* HandleExhaustedPool(FParticlePool& pool, UParticleSystem* system);
+
+	UPROPERTY()
+	TMap<UParticleSystem*, FParticlePool> pools;
+
+	// Components created for each system the first time it is spawned
+	UPROPERTY(Config)
+	int32 defaultPoolSize = 8;
+
+	// Pools never grow past this, the oldest component is stolen instead
+	UPROPERTY(Config)
+	int32 maxPoolSize = 64;
+
+	UPROPERTY(Config)
+	EParticlePoolPolicy exhaustedPolicy = EParticlePoolPolicy::EPP_StealOldest;
+};
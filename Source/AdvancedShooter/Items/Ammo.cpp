@@ -1,9 +1,9 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 #include <Components/BoxComponent.h>
-#include <Components/WidgetComponent.h>
 #include <Components/SphereComponent.h>
 #include <AdvancedShooter/ShooterCharacter.h>
 #include "Ammo.h"
+#include <AdvancedShooter/Items/ItemStateProfile.h>
 
 AAmmo::AAmmo()
 {
@@ -12,7 +12,6 @@ AAmmo::AAmmo()
 	SetRootComponent(ammoMesh);
 
 	GetCollisionBox()->SetupAttachment(GetRootComponent());
-	GetPickupWidget()->SetupAttachment(GetRootComponent());
 	GetAreaSphere()->SetupAttachment(GetRootComponent());
 
 	ammoCollisionSphere = CreateDefaultSubobject<USphereComponent>(TEXT("Ammo Collision Sphere"));
@@ -24,6 +23,13 @@ void AAmmo::BeginPlay()
 {
 	Super::BeginPlay();
 
+	// The pickup registry hands us to the character through AutoPickup instead
+	if (UsesPickupRegistry())
+	{
+		ammoCollisionSphere->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		return;
+	}
+
 	ammoCollisionSphere->OnComponentBeginOverlap.AddDynamic(this, &AAmmo::AmmoSphereOverlap);
 }
 
@@ -36,47 +42,39 @@ void AAmmo::SetItemProperties(EItemState state)
 {
 	Super::SetItemProperties(state);
 
-	switch (state)
-	{
-		case EItemState::EIS_Pickup:
-			// Set Ammo Mesh properties
-			ammoMesh->SetSimulatePhysics(false);
-			ammoMesh->SetEnableGravity(false);
-			ammoMesh->SetVisibility(true);
-			ammoMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-			ammoMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-			break;
-
-		case EItemState::EIS_Equipped:
-
-			// Set Ammo Mesh properties
-			ammoMesh->SetSimulatePhysics(false);
-			ammoMesh->SetEnableGravity(false);
-			ammoMesh->SetVisibility(true);
-			ammoMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-			ammoMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-			break;
-
-		case EItemState::EIS_Falling:
-
-			// Set Ammo mesh properties
-			ammoMesh->SetSimulatePhysics(true);
-			ammoMesh->SetEnableGravity(true);
-			ammoMesh->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
-			ammoMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-			ammoMesh->SetCollisionResponseToChannel(ECollisionChannel::ECC_WorldStatic, ECollisionResponse::ECR_Block);
-			break;
-
-		case EItemState::EIS_EquipInterping:
-
-			// Set Ammo mesh properties
-			ammoMesh->SetSimulatePhysics(false);
-			ammoMesh->SetEnableGravity(false);
-			ammoMesh->SetVisibility(true);
-			ammoMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-			ammoMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-			break;
-	}
+	// Ammo mesh is the root and follows the same setup as the item mesh
+	FItemStateProfile::Get(state).ApplyToMesh(ammoMesh);
+}
+
+float AAmmo::GetAutoPickupRadius() const
+{
+	return ammoCollisionSphere->GetScaledSphereRadius();
+}
+
+void AAmmo::AutoPickup(AShooterCharacter* _character)
+{
+	if (!_character || GetItemState() != EItemState::EIS_Pickup) return;
+
+	StartItemCurve(_character);
+}
+
+uint8 AAmmo::GetPoolRow() const
+{
+	return static_cast<uint8>(ammoType);
+}
+
+void AAmmo::SetPoolRow(uint8 row)
+{
+	ammoType = static_cast<EAmmoType>(row);
+}
+
+void AAmmo::ResetFromPool(const FTransform& transform, EItemRarity rarity)
+{
+	Super::ResetFromPool(transform, rarity);
+
+	// Only the overlap path uses the sphere, the pickup registry hands us over through AutoPickup
+	if (UsesPickupRegistry()) return;
+	ammoCollisionSphere->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
 }
 
 void AAmmo::AmmoSphereOverlap(UPrimitiveComponent* overlappedComponent, AActor* otherActor, UPrimitiveComponent* otherComp,
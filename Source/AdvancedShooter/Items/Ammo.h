@@ -22,10 +22,20 @@ public:
 	virtual void Tick(float DeltaTime) override;
 
 	FORCEINLINE EAmmoType GetAmmoType() const { return ammoType; }
+	FORCEINLINE UTexture2D* GetAmmoIconTexture() const { return ammoIconTexture; }
 
 	virtual void EnableCustomDepth() override;
 	virtual void DisableCustomDepth() override;
 
+	virtual void AutoPickup(AShooterCharacter* _character) override;
+
+	// Pooled per ammo type
+	virtual uint8 GetPoolRow() const override;
+	virtual void SetPoolRow(uint8 row) override;
+
+	// Turns the ammo collision sphere back on, the overlap pickup switches it off
+	virtual void ResetFromPool(const FTransform& transform, EItemRarity rarity) override;
+
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
@@ -33,6 +43,9 @@ protected:
 	// Overide of set item properties to set ammo mesh properties
 	virtual void SetItemProperties(EItemState state) override;
 
+	// Ammo collision sphere radius, ammo is grabbed by walking over it
+	virtual float GetAutoPickupRadius() const override;
+
 	// Called when overlapping area sphere
 	UFUNCTION()
 		void AmmoSphereOverlap(UPrimitiveComponent* overlappedComponent, AActor* otherActor, UPrimitiveComponent* otherComp,
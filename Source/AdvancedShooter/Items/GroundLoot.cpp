@@ -0,0 +1,349 @@
+#include "GroundLoot.h"
+#include <AdvancedShooter/AdvancedShooter.h>
+#include <AdvancedShooter/Items/Ammo.h>
+#include <AdvancedShooter/Items/Weapon.h>
+#include <AdvancedShooter/Items/ItemPoolSubsystem.h>
+#include <AdvancedShooter/Data/DataTableRegistry.h>
+#include <AdvancedShooter/Data/AssetStreamingSubsystem.h>
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Ground Loot Update"), STAT_GroundLootUpdate, STATGROUP_AdvancedShooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Ground Loot Instances"), STAT_GroundLootInstances, STATGROUP_AdvancedShooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Ground Loot Promoted"), STAT_GroundLootPromoted, STATGROUP_AdvancedShooter);
+DECLARE_MEMORY_STAT(TEXT("Ground Loot Memory"), STAT_GroundLootMemory, STATGROUP_AdvancedShooter);
+
+static FAutoConsoleCommandWithWorld DumpGroundLootCommand(
+	TEXT("Shooter.GroundLoot.Dump"),
+	TEXT("Logs instance and promoted counts, draw calls and estimated memory of every ground loot actor."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* world)
+	{
+		if (!world) return;
+
+		for (TActorIterator<AGroundLoot> it(world); it; ++it)
+		{
+			it->LogLootStats();
+		}
+	}));
+
+// Hidden instances keep their slot so the indices of the others never shift
+static const FTransform HiddenInstanceTransform(FQuat::Identity, FVector::ZeroVector, FVector::ZeroVector);
+
+// Sets default values
+AGroundLoot::AGroundLoot()
+{
+	PrimaryActorTick.bCanEverTick = true;
+
+	SetRootComponent(CreateDefaultSubobject<USceneComponent>(TEXT("Root")));
+}
+
+// Called when the game starts or when spawned
+void AGroundLoot::BeginPlay()
+{
+	Super::BeginPlay();
+
+	SetActorTickInterval(updateInterval);
+
+	CreateInstances();
+}
+
+void AGroundLoot::EndPlay(const EEndPlayReason::Type endPlayReason)
+{
+	// Untouched promoted items go back to the pool, anything a player took is theirs
+	for (const int32 index : promotedIndices)
+	{
+		if (!IsUntouched(index)) continue;
+		UItemPoolSubsystem::ReleasePooledItem(lootStates[index].promotedItem.Get());
+	}
+
+	promotedIndices.Reset();
+	grid.Reset();
+
+	DEC_DWORD_STAT_BY(STAT_GroundLootInstances, lootItems.Num());
+	SET_DWORD_STAT(STAT_GroundLootPromoted, 0);
+	SET_MEMORY_STAT(STAT_GroundLootMemory, 0);
+
+	Super::EndPlay(endPlayReason);
+}
+
+void AGroundLoot::CreateInstances()
+{
+	UDataTableRegistry* registry = UDataTableRegistry::Get();
+
+	typeMeshes.SetNum(lootTypes.Num());
+	dirtyTypeMeshes.Init(false, lootTypes.Num());
+	prefetchRows.Init(INDEX_NONE, lootTypes.Num());
+	prefetchRowsLeft = 0;
+
+	for (int32 i = 0; i < lootTypes.Num(); ++i)
+	{
+		// Only weapons stream their assets, ammo is drawn from its class defaults
+		const AWeapon* weaponDefaults = lootTypes[i].itemClass ? Cast<AWeapon>(lootTypes[i].itemClass->GetDefaultObject()) : NULL;
+		if (weaponDefaults)
+		{
+			prefetchRows[i] = lootTypes[i].row != INDEX_NONE ? lootTypes[i].row : (int32)weaponDefaults->GetWeaponType();
+			++prefetchRowsLeft;
+		}
+
+		UStaticMesh* groundMesh = lootTypes[i].groundMesh;
+
+		// Ammo already has a static mesh to stand in with
+		if (!groundMesh && lootTypes[i].itemClass)
+		{
+			const AAmmo* ammoDefaults = Cast<AAmmo>(lootTypes[i].itemClass->GetDefaultObject());
+			groundMesh = ammoDefaults ? ammoDefaults->GetAmmoMesh()->GetStaticMesh() : NULL;
+		}
+
+		UHierarchicalInstancedStaticMeshComponent* typeMesh = NewObject<UHierarchicalInstancedStaticMeshComponent>(this);
+		typeMesh->SetStaticMesh(groundMesh);
+		typeMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		typeMesh->SetCanEverAffectNavigation(false);
+		typeMesh->NumCustomDataFloats = 4;
+		typeMesh->SetupAttachment(GetRootComponent());
+		typeMesh->RegisterComponent();
+
+		typeMeshes[i] = typeMesh;
+	}
+
+	lootStates.SetNum(lootItems.Num());
+
+	for (int32 i = 0; i < lootItems.Num(); ++i)
+	{
+		const FGroundLootItem& lootItem = lootItems[i];
+		if (!typeMeshes.IsValidIndex(lootItem.lootType)) continue;
+
+		UHierarchicalInstancedStaticMeshComponent* typeMesh = typeMeshes[lootItem.lootType];
+		const int32 instanceIndex = typeMesh->AddInstance(lootItem.transform, false);
+
+		const FItemRarityTable* rarityRow = registry ? registry->GetRarityRow(lootItem.rarity) : NULL;
+		if (rarityRow)
+		{
+			typeMesh->SetCustomDataValue(instanceIndex, 0, rarityRow->glowColor.R, false);
+			typeMesh->SetCustomDataValue(instanceIndex, 1, rarityRow->glowColor.G, false);
+			typeMesh->SetCustomDataValue(instanceIndex, 2, rarityRow->glowColor.B, false);
+			typeMesh->SetCustomDataValue(instanceIndex, 3, rarityRow->numOfstars, false);
+		}
+
+		lootStates[i].instanceIndex = instanceIndex;
+		grid.Add(i, GetLootWorldTransform(i).GetLocation());
+	}
+
+	for (UHierarchicalInstancedStaticMeshComponent* typeMesh : typeMeshes)
+	{
+		typeMesh->MarkRenderStateDirty();
+	}
+
+	INC_DWORD_STAT_BY(STAT_GroundLootInstances, lootItems.Num());
+	SET_MEMORY_STAT(STAT_GroundLootMemory, lootItems.GetAllocatedSize() + lootStates.GetAllocatedSize());
+}
+
+// Called every updateInterval
+void AGroundLoot::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	SCOPE_CYCLE_COUNTER(STAT_GroundLootUpdate);
+
+	playerLocations.Reset();
+
+	for (FConstPlayerControllerIterator it = GetWorld()->GetPlayerControllerIterator(); it; ++it)
+	{
+		const APawn* pawn = it->Get() ? it->Get()->GetPawn() : NULL;
+		if (pawn) playerLocations.Add(pawn->GetActorLocation());
+	}
+
+	// Backwards so demoting and consuming can swap out of the list
+	for (int32 i = promotedIndices.Num() - 1; i >= 0; --i)
+	{
+		const int32 index = promotedIndices[i];
+
+		if (!IsUntouched(index))
+		{
+			// A player has it now, or it was destroyed
+			lootStates[index].bConsumed = true;
+			lootStates[index].promotedItem.Reset();
+			grid.Remove(index);
+			promotedIndices.RemoveAtSwap(i, 1, false);
+			continue;
+		}
+
+		const FVector lootLocation = GetLootWorldTransform(index).GetLocation();
+
+		const bool bPlayerNear = playerLocations.ContainsByPredicate([&lootLocation, this](const FVector& playerLocation)
+		{
+			return FVector::DistSquared(playerLocation, lootLocation) <= FMath::Square(demoteRadius);
+		});
+
+		if (bPlayerNear) continue;
+
+		Demote(index);
+		promotedIndices.RemoveAtSwap(i, 1, false);
+	}
+
+	PrefetchNearbyTypes();
+
+	for (const FVector& playerLocation : playerLocations)
+	{
+		queryResults.Reset();
+		grid.QuerySphere(playerLocation, promoteRadius, queryResults);
+
+		for (const int32 index : queryResults)
+		{
+			if (lootStates[index].promotedItem.IsValid()) continue;
+
+			Promote(index);
+		}
+	}
+
+	FlushInstanceUpdates();
+
+	SET_DWORD_STAT(STAT_GroundLootPromoted, promotedIndices.Num());
+}
+
+void AGroundLoot::PrefetchNearbyTypes()
+{
+	if (prefetchRowsLeft <= 0) return;
+
+	for (const FVector& playerLocation : playerLocations)
+	{
+		queryResults.Reset();
+		grid.QuerySphere(playerLocation, prefetchRadius, queryResults);
+
+		for (const int32 index : queryResults)
+		{
+			const int32 lootType = lootItems[index].lootType;
+			if (!prefetchRows.IsValidIndex(lootType) || prefetchRows[lootType] == INDEX_NONE) continue;
+
+			UAssetStreamingSubsystem::PrefetchRow(this, EGameDataTable::EGDT_Weapon, (uint8)prefetchRows[lootType]);
+
+			prefetchRows[lootType] = INDEX_NONE;
+			if (--prefetchRowsLeft <= 0) return;
+		}
+	}
+}
+
+void AGroundLoot::Promote(int32 index)
+{
+	const FGroundLootItem& lootItem = lootItems[index];
+	if (!lootTypes.IsValidIndex(lootItem.lootType)) return;
+
+	const FGroundLootType& lootType = lootTypes[lootItem.lootType];
+
+	AItem* item = UItemPoolSubsystem::AcquirePooledItem(this, lootType.itemClass, lootType.row, GetLootWorldTransform(index), lootItem.rarity);
+	if (!item) return;
+
+	FGroundLootState& lootState = lootStates[index];
+	lootState.promotedItem = item;
+	promotedIndices.Add(index);
+
+	SetInstanceTransform(lootItem.lootType, lootState.instanceIndex, HiddenInstanceTransform);
+}
+
+void AGroundLoot::Demote(int32 index)
+{
+	FGroundLootState& lootState = lootStates[index];
+
+	UItemPoolSubsystem::ReleasePooledItem(lootState.promotedItem.Get());
+	lootState.promotedItem.Reset();
+
+	const FGroundLootItem& lootItem = lootItems[index];
+	SetInstanceTransform(lootItem.lootType, lootState.instanceIndex, lootItem.transform);
+}
+
+void AGroundLoot::SetInstanceTransform(int32 lootType, int32 instanceIndex, const FTransform& transform)
+{
+	typeMeshes[lootType]->UpdateInstanceTransform(instanceIndex, transform, false, false, true);
+	dirtyTypeMeshes[lootType] = true;
+}
+
+void AGroundLoot::FlushInstanceUpdates()
+{
+	for (int32 i = 0; i < dirtyTypeMeshes.Num(); ++i)
+	{
+		if (!dirtyTypeMeshes[i]) continue;
+
+		typeMeshes[i]->MarkRenderStateDirty();
+		dirtyTypeMeshes[i] = false;
+	}
+}
+
+bool AGroundLoot::IsUntouched(int32 index) const
+{
+	const AItem* item = lootStates[index].promotedItem.Get();
+	if (!item || item->GetItemState() != EItemState::EIS_Pickup) return false;
+
+	// Still a pickup but somewhere else, eg dropped back down after a swap
+	return FVector::DistSquared(item->GetActorLocation(), GetLootWorldTransform(index).GetLocation()) < 1.f;
+}
+
+FTransform AGroundLoot::GetLootWorldTransform(int32 index) const
+{
+	return lootItems[index].transform * GetActorTransform();
+}
+
+void AGroundLoot::ScatterLoot()
+{
+	if (lootTypes.Num() == 0) return;
+
+	Modify();
+
+	FRandomStream scatterStream(GetUniqueID());
+
+	lootItems.Reset(scatterCount);
+
+	for (int32 i = 0; i < scatterCount; ++i)
+	{
+		FGroundLootItem& lootItem = lootItems.AddDefaulted_GetRef();
+		lootItem.lootType = scatterStream.RandRange(0, lootTypes.Num() - 1);
+		lootItem.rarity = static_cast<EItemRarity>(scatterStream.RandRange(0, static_cast<int32>(EItemRarity::EIR_MAX) - 1));
+		lootItem.transform = FTransform(
+			FRotator(0.f, scatterStream.FRandRange(0.f, 360.f), 0.f),
+			FVector(scatterStream.FRandRange(-scatterExtent, scatterExtent), scatterStream.FRandRange(-scatterExtent, scatterExtent), 0.f));
+	}
+}
+
+void AGroundLoot::LogLootStats() const
+{
+	SIZE_T instanceBytes = lootItems.GetAllocatedSize() + lootStates.GetAllocatedSize();
+	int32 drawnTypes = 0;
+
+	for (const UHierarchicalInstancedStaticMeshComponent* typeMesh : typeMeshes)
+	{
+		if (!typeMesh) continue;
+
+		instanceBytes += typeMesh->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+		if (typeMesh->GetInstanceCount() > 0) ++drawnTypes;
+	}
+
+	// What every item would cost as an actor, taken from a promoted one
+	SIZE_T actorBytes = 0;
+
+	for (const int32 index : promotedIndices)
+	{
+		const AItem* item = lootStates[index].promotedItem.Get();
+		if (!item) continue;
+
+		actorBytes = item->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+
+		TInlineComponentArray<UActorComponent*> components(item);
+		for (const UActorComponent* component : components)
+		{
+			actorBytes += component->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+		}
+		break;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("Ground loot %s: %d items, %d promoted, %d instanced draws (before LOD and culling), %.2f MB as instances"),
+		*GetName(), lootItems.Num(), promotedIndices.Num(), drawnTypes, instanceBytes / (1024.f * 1024.f));
+
+	if (actorBytes > 0)
+	{
+		UE_LOG(LogTemp, Log, TEXT("Ground loot %s: about %.2f MB and at least %d draws if every item were an actor"),
+			*GetName(), actorBytes * lootItems.Num() / (1024.f * 1024.f), lootItems.Num());
+	}
+}
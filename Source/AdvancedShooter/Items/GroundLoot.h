@@ -0,0 +1,164 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include <AdvancedShooter/Items/Item.h>
+#include <AdvancedShooter/Items/SpatialHashGrid.h>
+#include "GroundLoot.generated.h"
+
+class UHierarchicalInstancedStaticMeshComponent;
+class UStaticMesh;
+
+// One kind of item the ground loot can hold, all of its instances share one instanced mesh
+USTRUCT(BlueprintType)
+struct FGroundLootType
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	TSubclassOf<AItem> itemClass;
+
+	// Weapon or ammo type row, INDEX_NONE uses the class defaults
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	int32 row = INDEX_NONE;
+
+	// Static stand in drawn until the item is promoted, ammo falls back to its ammo mesh
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	UStaticMesh* groundMesh = NULL;
+};
+
+// One item lying on the ground
+USTRUCT(BlueprintType)
+struct FGroundLootItem
+{
+	GENERATED_BODY()
+
+	// Index into lootTypes
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	int32 lootType = 0;
+
+	// Relative to the ground loot actor
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (MakeEditWidget = "true"))
+	FTransform transform;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	EItemRarity rarity = EItemRarity::EIR_Common;
+};
+
+// Runtime state of one ground item, at the same index as its FGroundLootItem
+struct FGroundLootState
+{
+	// Instance in its types mesh, hidden by zero scale while promoted so no other index moves
+	int32 instanceIndex = INDEX_NONE;
+
+	// Real actor standing in for the instance while a player is close
+	TWeakObjectPtr<AItem> promotedItem;
+
+	// Picked up or moved by a player, never drawn as an instance again
+	bool bConsumed = false;
+};
+
+/*
+Draws loot nobody is near as instanced static meshes, one draw per loot type, with the rarity glow colour
+and star count in per instance custom data (0-2 glow colour, 3 stars) for the ground material to read.
+Items within promoteRadius of a player are swapped for real weapon and ammo actors from the item pool,
+and swapped back once every player is beyond demoteRadius, unless a player took or moved them.
+Weapon assets start streaming once a player is within prefetchRadius, so the promoted actor rarely shows its placeholder.
+*/
+UCLASS()
+class ADVANCEDSHOOTER_API AGroundLoot : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	// Sets default values for this actor's properties
+	AGroundLoot();
+
+	// Called every updateInterval
+	virtual void Tick(float DeltaTime) override;
+
+	// Instances, promoted actors and estimated memory against every item being an actor
+	void LogLootStats() const;
+
+	int32 GetNumLoot() const { return lootItems.Num(); }
+	int32 GetNumPromoted() const { return promotedIndices.Num(); }
+
+protected:
+	// Called when the game starts or when spawned
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type endPlayReason) override;
+
+	// Fills lootItems with scatterCount random items in a square of scatterExtent, for building test maps
+	UFUNCTION(CallInEditor, Category = "Ground Loot")
+	void ScatterLoot();
+
+private:
+	void CreateInstances();
+
+	void Promote(int32 index);
+	void Demote(int32 index);
+
+	// Moves an instance without touching the render state, FlushInstanceUpdates sends every change of the update at once
+	void SetInstanceTransform(int32 lootType, int32 instanceIndex, const FTransform& transform);
+	void FlushInstanceUpdates();
+
+	// Streams the assets of loot types near a player that havent been streamed yet
+	void PrefetchNearbyTypes();
+
+	// True while the promoted item is still where it was promoted and waiting to be picked up
+	bool IsUntouched(int32 index) const;
+
+	FTransform GetLootWorldTransform(int32 index) const;
+
+	UPROPERTY(EditAnywhere, Category = "Ground Loot", meta = (AllowPrivateAccess = "true"))
+	TArray<FGroundLootType> lootTypes;
+
+	UPROPERTY(EditAnywhere, Category = "Ground Loot", meta = (AllowPrivateAccess = "true"))
+	TArray<FGroundLootItem> lootItems;
+
+	// Players this close get the real actor
+	UPROPERTY(EditAnywhere, Category = "Ground Loot", meta = (AllowPrivateAccess = "true"))
+	float promoteRadius = 1000.f;
+
+	// Larger than promoteRadius so walking along the edge doesnt swap items back and forth
+	UPROPERTY(EditAnywhere, Category = "Ground Loot", meta = (AllowPrivateAccess = "true"))
+	float demoteRadius = 1500.f;
+
+	// Players this close start streaming the assets of the loot, should be well beyond promoteRadius
+	UPROPERTY(EditAnywhere, Category = "Ground Loot", meta = (AllowPrivateAccess = "true"))
+	float prefetchRadius = 4000.f;
+
+	// Seconds between promotion checks
+	UPROPERTY(EditAnywhere, Category = "Ground Loot", meta = (AllowPrivateAccess = "true"))
+	float updateInterval = 0.2f;
+
+	UPROPERTY(EditAnywhere, Category = "Ground Loot|Scatter", meta = (AllowPrivateAccess = "true"))
+	int32 scatterCount = 5000;
+
+	UPROPERTY(EditAnywhere, Category = "Ground Loot|Scatter", meta = (AllowPrivateAccess = "true"))
+	float scatterExtent = 20000.f;
+
+	// One instanced mesh per loot type
+	UPROPERTY(Transient)
+	TArray<UHierarchicalInstancedStaticMeshComponent*> typeMeshes;
+
+	// Loot types with instances moved this update, their render state is rebuilt once at the end of it
+	TArray<bool> dirtyTypeMeshes;
+
+	TArray<FGroundLootState> lootStates;
+
+	// Indices of loot not yet consumed, by world location
+	TSpatialHashGrid<int32> grid;
+
+	TArray<int32> promotedIndices;
+
+	// Weapon row of each loot type, INDEX_NONE for types with nothing to stream or already prefetched
+	TArray<int32> prefetchRows;
+	int32 prefetchRowsLeft = 0;
+
+	// Per tick scratch
+	TArray<FVector> playerLocations;
+	TArray<int32> queryResults;
+};
@@ -1,17 +1,47 @@
 #include "Item.h"
+#include <AdvancedShooter/AdvancedShooter.h>
 #include <Components/BoxComponent.h>
-#include <Components/WidgetComponent.h>
 #include <Components/SphereComponent.h>
 #include <AdvancedShooter/ShooterCharacter.h>
 #include <Kismet/GameplayStatics.h>
 #include "Camera/CameraComponent.h"
 #include <Curves/CurveVector.h>
+#include <AdvancedShooter/Effects/ItemPulseSubsystem.h>
+#include <AdvancedShooter/Items/ItemInterpSubsystem.h>
+#include <AdvancedShooter/Items/PickupRegistrySubsystem.h>
+#include <AdvancedShooter/Items/ItemStateProfile.h>
+#include <AdvancedShooter/Items/ItemPoolSubsystem.h>
+#include <AdvancedShooter/Data/DataTableRegistry.h>
+#include <AdvancedShooter/Data/AssetStreamingSubsystem.h>
+#include "UObject/UObjectIterator.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Item Ticks"), STAT_ItemTicks, STATGROUP_AdvancedShooter);
+DECLARE_CYCLE_STAT(TEXT("Item State Transition"), STAT_ItemStateTransition, STATGROUP_AdvancedShooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Item State Transitions"), STAT_ItemStateTransitions, STATGROUP_AdvancedShooter);
+
+static void OnItemAlwaysTickChanged(IConsoleVariable* variable)
+{
+	for (TObjectIterator<AItem> it; it; ++it)
+	{
+		if (it->IsTemplate() || !it->HasActorBegunPlay()) continue;
+		it->RefreshTickEnabled();
+	}
+}
+
+static TAutoConsoleVariable<int32> CVarItemAlwaysTick(
+	TEXT("Shooter.Items.AlwaysTick"),
+	0,
+	TEXT("1: every item ticks every frame like before, for comparing the Item Ticks stat."),
+	FConsoleVariableDelegate::CreateStatic(&OnItemAlwaysTickChanged),
+	ECVF_Cheat);
 
 // Sets default values
 AItem::AItem()
 {
- 	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
+ 	// Pulsing and interping are batched elsewhere, subclasses turn ticking on when they need it, see RefreshTickEnabled
 	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
 
 	itemMesh = CreateDefaultSubobject<USkeletalMeshComponent>(TEXT("Item Mesh"));
 	SetRootComponent(itemMesh);
@@ -21,9 +51,6 @@ AItem::AItem()
 	boxCollision->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
 	boxCollision->SetCollisionResponseToChannel(ECollisionChannel::ECC_Visibility, ECollisionResponse::ECR_Block);
 
-	pickupWidget = CreateDefaultSubobject<UWidgetComponent>(TEXT("Pickup Widget"));
-	pickupWidget->SetupAttachment(GetRootComponent());
-
 
 	areaSphere = CreateDefaultSubobject<USphereComponent>(TEXT("Area Sphere"));
 	areaSphere->SetupAttachment(GetRootComponent());
@@ -34,22 +61,47 @@ AItem::AItem()
 void AItem::BeginPlay()
 {
 	Super::BeginPlay();
-	if (!pickupWidget) return;
-
-	pickupWidget->SetVisibility(false);
 
 	SetActiveStars();
-	
-	// Setup overlap for area sphere
-	areaSphere->OnComponentBeginOverlap.AddDynamic(this, &AItem::OnSphereOverlap);
-	areaSphere->OnComponentEndOverlap.AddDynamic(this, &AItem::OnSphereEndOverlap);
+
+	bUsePickupRegistry = UPickupRegistrySubsystem::IsSpatialHashEnabled() && GetWorld()->GetSubsystem<UPickupRegistrySubsystem>() != NULL;
+
+	if (!bUsePickupRegistry)
+	{
+		// Setup overlap for area sphere
+		areaSphere->OnComponentBeginOverlap.AddDynamic(this, &AItem::OnSphereOverlap);
+		areaSphere->OnComponentEndOverlap.AddDynamic(this, &AItem::OnSphereEndOverlap);
+	}
 
 	SetItemProperties(itemState);
 
+	RefreshPickupRegistration();
+
 	// Set custom depth to disable
 	InitCustomDepth();
 
-	ResetPulseTimer();
+	RefreshPulse();
+
+	RefreshTickEnabled();
+}
+
+void AItem::EndPlay(const EEndPlayReason::Type endPlayReason)
+{
+	if (UPickupRegistrySubsystem* pickupRegistry = GetWorld()->GetSubsystem<UPickupRegistrySubsystem>())
+	{
+		pickupRegistry->RemovePickup(this);
+	}
+
+	// Dropped weapons stay in the world as pickups, so pooled items can still be destroyed by a level or benchmark
+	if (endPlayReason == EEndPlayReason::Destroyed)
+	{
+		if (UItemPoolSubsystem* itemPool = GetWorld()->GetSubsystem<UItemPoolSubsystem>())
+		{
+			itemPool->ForgetItem(this);
+		}
+	}
+
+	Super::EndPlay(endPlayReason);
 }
 
 void AItem::OnConstruction(const FTransform& transform)
@@ -70,10 +122,7 @@ void AItem::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
-	ItemInterp(DeltaTime);
-
-	// Get curve values from pusle curve and set dynamic mat intance
-	UpdatePulse();
+	INC_DWORD_STAT(STAT_ItemTicks);
 }
 
 void AItem::OnSphereOverlap(UPrimitiveComponent* overlappedComponent, AActor* otherActor, UPrimitiveComponent* otherComp, 
@@ -100,11 +149,8 @@ void AItem::OnSphereEndOverlap(UPrimitiveComponent* overlappedComponent, AActor*
 
 void AItem::SetActiveStars()
 {
-	// The zero element isnt used
-	for (int32 i = 0; i <= 5; ++i)
-	{
-		activeStars.Add(false);
-	}
+	// The zero element isnt used, cleared first since pooled items are reset with a new rarity
+	activeStars.Init(false, 6);
 
 	switch (itemRarity)
 	{
@@ -138,107 +184,162 @@ void AItem::SetActiveStars()
 
 void AItem::SetItemState(EItemState state)
 {
+	// Per frame totals show what a bulk pickup or weapon drop costs
+	SCOPE_CYCLE_COUNTER(STAT_ItemStateTransition);
+	INC_DWORD_STAT(STAT_ItemStateTransitions);
+
 	itemState = state;
 	SetItemProperties(state);
+
+	if (!HasActorBegunPlay()) return;
+
+	// Pulse curve depends on the state
+	RefreshPulse();
+	RefreshTickEnabled();
+	RefreshPickupRegistration();
 }
 
-void AItem::SetItemProperties(EItemState state)
+void AItem::RefreshTickEnabled()
+{
+	SetActorTickEnabled(CVarItemAlwaysTick.GetValueOnGameThread() != 0 || WantsTick());
+}
+
+bool AItem::WantsTick() const
 {
-	switch (state)
+	// Pulsing and interping are done by their subsystems
+	return false;
+}
+
+void AItem::RefreshPickupRegistration()
+{
+	if (!bUsePickupRegistry) return;
+
+	UPickupRegistrySubsystem* pickupRegistry = GetWorld()->GetSubsystem<UPickupRegistrySubsystem>();
+	if (!pickupRegistry) return;
+
+	if (itemState == EItemState::EIS_Pickup)
 	{
-		case EItemState::EIS_Pickup:
-			// Set Mesh properties
-			itemMesh->SetSimulatePhysics(false);
-			itemMesh->SetEnableGravity(false);
-			itemMesh->SetVisibility(true);
-			itemMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-			itemMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-
-			// Set area sphere properties
-			areaSphere->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Overlap);
-			areaSphere->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
-
-			// Set box collision properties
-			boxCollision->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-			boxCollision->SetCollisionResponseToChannel(ECollisionChannel::ECC_Visibility,ECollisionResponse::ECR_Block);
-			boxCollision->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
-			break;
+		pickupRegistry->AddPickup(this, areaSphere->GetScaledSphereRadius(), GetAutoPickupRadius());
+		return;
+	}
 
-		case EItemState::EIS_Equipped:
+	pickupRegistry->RemovePickup(this);
+}
 
-			pickupWidget->SetVisibility(false);
-			// Set Mesh properties
-			itemMesh->SetSimulatePhysics(false);
-			itemMesh->SetEnableGravity(false);
-			itemMesh->SetVisibility(true);
-			itemMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-			itemMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+float AItem::GetAutoPickupRadius() const
+{
+	return 0.f;
+}
 
-			// Set area sphere properties
-			areaSphere->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-			areaSphere->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+void AItem::AutoPickup(AShooterCharacter* _character)
+{
+}
 
-			// Set box collision properties
-			boxCollision->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-			boxCollision->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-			break;
+uint8 AItem::GetPoolRow() const
+{
+	return 0;
+}
 
-		case EItemState::EIS_Falling:
+void AItem::SetPoolRow(uint8 row)
+{
+}
 
-			// Set mesh properties
-			itemMesh->SetSimulatePhysics(true);
-			itemMesh->SetEnableGravity(true);
-			itemMesh->SetVisibility(true);
-			itemMesh->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
-			itemMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-			itemMesh->SetCollisionResponseToChannel(ECollisionChannel::ECC_WorldStatic, ECollisionResponse::ECR_Block);
+void AItem::ResetFromPool(const FTransform& transform, EItemRarity rarity)
+{
+	DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+	SetActorTransform(transform, false, NULL, ETeleportType::TeleportPhysics);
+	SetActorHiddenInGame(false);
 
-			// Set area sphere properties
-			areaSphere->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-			areaSphere->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	character = NULL;
+	slotIndex = 0;
+	bIsCharacterInventoryFull = false;
+	bIsInterping = false;
+	bCanChangeCustomDepth = true;
 
-			// Set box collision properties
-			boxCollision->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-			boxCollision->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-			break;
+	if (rarity != EItemRarity::EIR_MAX) itemRarity = rarity;
 
-		case EItemState::EIS_EquipInterping:
-			pickupWidget->SetVisibility(false);
+	SetActiveStars();
+	SetRarityData();
 
-			// Set mesh properties
-			itemMesh->SetSimulatePhysics(false);
-			itemMesh->SetEnableGravity(false);
-			itemMesh->SetVisibility(true);
-			itemMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-			itemMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	// The dynamic material is kept, only its rarity colour and glow need resetting
+	if (dynamicMaterialInstance)
+	{
+		dynamicMaterialInstance->SetVectorParameterValue(TEXT("FresnelColor"), glowColor);
+	}
 
-			// Set area sphere properties
-			areaSphere->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-			areaSphere->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	EnableGlowMaterial();
+	DisableCustomDepth();
 
-			// Set box collision properties
-			boxCollision->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-			boxCollision->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-			break;
+	SetItemState(EItemState::EIS_Pickup);
+}
 
-		case EItemState::EIS_PickedUp:
-			pickupWidget->SetVisibility(false);
+void AItem::ReturnToPool()
+{
+	GetWorldTimerManager().ClearAllTimersForObject(this);
 
-			// Set mesh properties
-			itemMesh->SetSimulatePhysics(false);
-			itemMesh->SetEnableGravity(false);
-			itemMesh->SetVisibility(false);
-			itemMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-			itemMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	if (UItemInterpSubsystem* itemInterp = GetWorld()->GetSubsystem<UItemInterpSubsystem>())
+	{
+		itemInterp->RemoveItem(this);
+	}
 
-			// Set area sphere properties
-			areaSphere->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-			areaSphere->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
 
-			// Set box collision properties
-			boxCollision->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-			boxCollision->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-			break;
+	// Picked up turns off collision, the pulse and the pickup registration
+	SetItemState(EItemState::EIS_PickedUp);
+	SetActorHiddenInGame(true);
+	SetActorScale3D(FVector(1.f));
+
+	character = NULL;
+	bIsInterping = false;
+}
+
+void AItem::RefreshPulse()
+{
+	UItemPulseSubsystem* itemPulse = GetWorld() ? GetWorld()->GetSubsystem<UItemPulseSubsystem>() : NULL;
+	if (!itemPulse) return;
+
+	const FVector parameterScale(glowAmount, fresnelExponent, fresnelReflectFraction);
+
+	switch (itemState)
+	{
+	case EItemState::EIS_Pickup:
+		if (!pulseCurve) break;
+
+		itemPulse->AddPulse(this, pulseCurve, pulseCurveTime, parameterScale);
+		return;
+
+	case EItemState::EIS_EquipInterping:
+		if (!interpPulseCurve) break;
+
+		// Plays once over the interp
+		itemPulse->AddPulse(this, interpPulseCurve, 0.f, parameterScale);
+		return;
+
+	default:
+		break;
+	}
+
+	itemPulse->RemovePulse(this);
+}
+
+void AItem::SetItemProperties(EItemState state)
+{
+	const FItemStateProfile& profile = FItemStateProfile::Get(state);
+
+	profile.ApplyToMesh(itemMesh);
+	profile.boxCollision.Apply(boxCollision);
+
+	// The pickup registry does the area spheres job without collision
+	if (bUsePickupRegistry)
+	{
+		FItemCollisionProfile areaSphereProfile = profile.areaSphere;
+		areaSphereProfile.collisionEnabled = ECollisionEnabled::NoCollision;
+		areaSphereProfile.Apply(areaSphere);
+	}
+
+	else
+	{
+		profile.areaSphere.Apply(areaSphere);
 	}
 }
 
@@ -262,7 +363,6 @@ void AItem::StartItemCurve(AShooterCharacter* _character, bool bForcePlaySound)
 
 	SetItemState(EItemState::EIS_EquipInterping);
 
-	GetWorldTimerManager().ClearTimer(pulseTimer);
 	GetWorldTimerManager().SetTimer(itemInterpTimer, this, &AItem::FinishInterping, zCurveTime);
 
 	// Get cameras initial yaw
@@ -275,73 +375,36 @@ void AItem::StartItemCurve(AShooterCharacter* _character, bool bForcePlaySound)
 	interpInitialYawOffset = itemRotationYaw - cameraRotationYaw;
 
 	bCanChangeCustomDepth = false;
-}
-
-void AItem::UpdatePulse()
-{
-	if (itemState != EItemState::EIS_Pickup && !dynamicMaterialInstance) return;
-
-	float elapsedTime = 0;
-	FVector curveValue = FVector::ZeroVector;
 
-	switch (itemState)
-	{
-	case EItemState::EIS_Pickup:
+	UItemInterpSubsystem* itemInterp = GetWorld()->GetSubsystem<UItemInterpSubsystem>();
+	if (!itemInterp) return;
 
-		if (!pulseCurve) return;
-
-		elapsedTime = GetWorldTimerManager().GetTimerElapsed(pulseTimer);
-		curveValue = pulseCurve->GetVectorValue(elapsedTime);
-		break;
+	FItemInterpParams interpParams;
+	interpParams.character = character;
+	interpParams.interpLocationIndex = GetInterpLocationIndex();
+	interpParams.zCurve = itemZCurve;
+	interpParams.scaleCurve = itemScaleCurve;
+	interpParams.startLocation = itemInterpStartlocation;
+	interpParams.yawOffset = interpInitialYawOffset;
 
-	case EItemState::EIS_EquipInterping:
-		if (!interpPulseCurve) return;
-
-		elapsedTime = GetWorldTimerManager().GetTimerElapsed(itemInterpTimer);
-		curveValue = interpPulseCurve->GetVectorValue(elapsedTime);
-		break;
-
-	default:
-		break;
-	}
-
-	dynamicMaterialInstance->SetScalarParameterValue(TEXT("GlowAmount"), curveValue.X * glowAmount);
+	itemInterp->AddItem(this, interpParams);
+}
 
-	dynamicMaterialInstance->SetScalarParameterValue(TEXT("FresnelExponent"), curveValue.Y * fresnelExponent);
+void AItem::ShowPlaceholderMesh()
+{
+	const UAssetStreamingSubsystem* streaming = GetWorld() ? GetWorld()->GetSubsystem<UAssetStreamingSubsystem>() : NULL;
+	if (!streaming || !streaming->GetPlaceholderMesh()) return;
 
-	dynamicMaterialInstance->SetScalarParameterValue(TEXT("FresnelReflectFraction"), curveValue.Z * fresnelReflectFraction);
+	GetItemMesh()->SetSkeletalMesh(streaming->GetPlaceholderMesh());
+	GetItemMesh()->SetAnimInstanceClass(NULL);
 }
 
 void AItem::SetRarityData()
 {
-	FItemRarityTable* rarityRow = NULL;
-
-	switch (itemRarity)
-	{
-	case EItemRarity::EIR_Damaged:
-		rarityRow = GetRarityDataTable()->FindRow<FItemRarityTable>(FName("Damaged"), TEXT(""));
-		break;
-
-	case EItemRarity::EIR_Common:
-		rarityRow = GetRarityDataTable()->FindRow<FItemRarityTable>(FName("Common"), TEXT(""));
-		break;
-
-	case EItemRarity::EIR_Uncommon:
-		rarityRow = GetRarityDataTable()->FindRow<FItemRarityTable>(FName("Uncommon"), TEXT(""));
-		break;
-
-	case EItemRarity::EIR_Rare:
-		rarityRow = GetRarityDataTable()->FindRow<FItemRarityTable>(FName("Rare"), TEXT(""));
-		break;
-
-	case EItemRarity::EIR_Legendary:
-		rarityRow = GetRarityDataTable()->FindRow<FItemRarityTable>(FName("Legendary"), TEXT(""));
-		break;
-
-	default:
-		break;
-	}
+	UDataTableRegistry* registry = UDataTableRegistry::Get();
+	if (!registry) return;
 
+	const FItemRarityTable* rarityRow = registry->GetRarityRow(itemRarity);
 	if (!rarityRow) return;
 
 	glowColor = rarityRow->glowColor;
@@ -358,24 +421,15 @@ void AItem::SetRarityData()
 	}
 }
 
-UDataTable* AItem::GetRarityDataTable()
-{
-	// Load data in the item rarity data table
-
-	// Path to the item rarity data table
-	FString rarityTablePath = TEXT("DataTable'/Game/_Game/DataTable/DT_ItemRarity.DT_ItemRarity'");
-
-	UDataTable* rarityTableObject = Cast<UDataTable>(StaticLoadObject(UDataTable::StaticClass(), NULL, *rarityTablePath));
-
-	if (!rarityTableObject) return NULL;
-
-	return rarityTableObject;
-}
-
 void AItem::FinishInterping()
 {
 	bIsInterping = false;
 
+	if (UItemInterpSubsystem* itemInterp = GetWorld()->GetSubsystem<UItemInterpSubsystem>())
+	{
+		itemInterp->RemoveItem(this);
+	}
+
 	if (!character) return;
 
 	// Subtract 1 from the item amount at index
@@ -392,75 +446,21 @@ void AItem::FinishInterping()
 	DisableCustomDepth();
 }
 
-void AItem::ItemInterp(float deltaTime)
+int32 AItem::GetInterpLocationIndex() const
 {
-	if (!bIsInterping) return;
-
-	if (!character && !itemZCurve && !itemScaleCurve) return;
-
-	// Elapsed time since we started itemInterpTimer
-	const float elapsedTime = GetWorldTimerManager().GetTimerElapsed(itemInterpTimer);
-
-	// Get curve value at elapsed time
-	const float curveValue = itemZCurve->GetFloatValue(elapsedTime);
-
-	// Get item start location
-	FVector itemLocation = itemInterpStartlocation;
-
-	// Get location in front of camera
-	const FVector cameraInterpLocation = GetInterpLocation();
-
-	// Vector from item to camera location
-	const FVector itemToCamera = FVector(0.f, 0.f, (cameraInterpLocation - itemLocation).Z);
-
-	// Scale factor to multi with curve value
-	const float deltaZ = itemToCamera.Size();
-
-	const FVector currentLocation = GetActorLocation();
-
-	// Interolated x and y value
-	const float interpXValue = FMath::FInterpTo(currentLocation.X, cameraInterpLocation.X, deltaTime, 30.f);
-	const float interpYValue = FMath::FInterpTo(currentLocation.Y, cameraInterpLocation.Y, deltaTime, 30.f);
-
-	itemLocation.X = interpXValue;
-	itemLocation.Y = interpYValue;
-
-	// Adding curve value to the Z comp of the start location (Scaled by deltaZ)
-	itemLocation.Z += curveValue * deltaZ;
-
-	SetActorLocation(itemLocation, true, NULL, ETeleportType::TeleportPhysics);
-	
-	// Camera rotation this frame
-	const FRotator cameraRotation = character->GetFollowCamera()->GetComponentRotation();
-
-	// Camera rotation
-	FRotator itemRotation = FRotator(0.f, cameraRotation.Yaw + interpInitialYawOffset, 0.f);
-	SetActorRotation(itemRotation, ETeleportType::TeleportPhysics);
-
-	const float scaleCurveValue = itemScaleCurve->GetFloatValue(elapsedTime);
-
-	SetActorScale3D(FVector(scaleCurveValue, scaleCurveValue, scaleCurveValue));
-}
-
-FVector AItem::GetInterpLocation()
-{
-	if (!character) return FVector::ZeroVector;
-
 	switch (itemType)
 	{
 		case EItemType::EIT_Ammo:
-			return character->GetInterpLocation(interpLocIndex).sceneComp->GetComponentLocation();
-			break;
-		
+			return interpLocIndex;
+
 		case EItemType::EIT_Weapon:
-			return character->GetInterpLocation(0).sceneComp->GetComponentLocation();
-			break;
+			return 0;
 
 		default:
 			break;
 	}
 
-	return FVector();
+	return INDEX_NONE;
 }
 
 void AItem::EnableCustomDepth()
@@ -492,12 +492,6 @@ void AItem::InitCustomDepth()
 	DisableCustomDepth();
 }
 
-void AItem::ResetPulseTimer()
-{
-	if (itemState != EItemState::EIS_Pickup) return;
-	GetWorldTimerManager().SetTimer(pulseTimer, this, &AItem::ResetPulseTimer, pulseCurveTime);
-}
-
 void AItem::PlayPickupSound(bool bForcePlaySound)
 {
 	if (!character && !pickupSound) return;
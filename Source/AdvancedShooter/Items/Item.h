@@ -9,7 +9,6 @@
 
 class UBoxComponent;
 class USphereComponent;
-class UWidgetComponent;
 class UCurveFloat;
 class UCurveVector;
 class AShooterCharacter;
@@ -91,7 +90,6 @@ public:
 	virtual void Tick(float DeltaTime) override;
 
 	// GETTERS
-	FORCEINLINE UWidgetComponent* GetPickupWidget() const { return pickupWidget; }
 	FORCEINLINE USphereComponent* GetAreaSphere() const { return areaSphere; }
 	FORCEINLINE UBoxComponent* GetCollisionBox() const { return boxCollision; }
 	FORCEINLINE EItemState GetItemState() const { return itemState; }
@@ -110,6 +108,14 @@ public:
 	FORCEINLINE float GetDamageScalar() const { return damageScalar; }
 	FORCEINLINE float GetHeadshotDamageScalar() const { return headshotDamageScalar; }
 
+	// Shown by the characters shared pickup widget
+	FORCEINLINE const FString& GetItemName() const { return itemName; }
+	FORCEINLINE const TArray<bool>& GetActiveStars() const { return activeStars; }
+	FORCEINLINE FLinearColor GetLightColor() const { return lightColor; }
+	FORCEINLINE FLinearColor GetDarkColor() const { return darkColor; }
+	FORCEINLINE UTexture2D* GetItemIcon() const { return iconItem; }
+	FORCEINLINE UTexture2D* GetAmmoIcon() const { return iconAmmo; }
+
 	// SETTERS
 	FORCEINLINE void SetSlotIndex(int32 index) { slotIndex = index; }
 	FORCEINLINE void SetCharacter(AShooterCharacter* _character) { character = _character; }
@@ -124,10 +130,30 @@ public:
 	FORCEINLINE void SetDynamicMaterialInstance(UMaterialInstanceDynamic* dynamicInst) { dynamicMaterialInstance = dynamicInst; }
 	FORCEINLINE void SetMaterialIndex(int32 index) { materialIndex = index; }
 
+	// Turns ticking on while the item has something of its own to animate and off once it is idle
+	void RefreshTickEnabled();
+
 	// Called from aShooterCharacterClass
 	void StartItemCurve(AShooterCharacter* _character, bool bForcePlaySound = false);
 	void PlayEquipSound(bool bForcePlaySound = false);
 
+	// Called from the character once it comes within the auto pickup radius
+	virtual void AutoPickup(AShooterCharacter* _character);
+
+	// ITEM POOL, see UItemPoolSubsystem
+
+	// Data table row the item was built from, items only share a pool with the same row
+	virtual uint8 GetPoolRow() const;
+
+	// Called on a deferred spawn before construction reads the row
+	virtual void SetPoolRow(uint8 row);
+
+	// Turns a dormant item back into a fresh pickup, rarity EIR_MAX keeps the current one
+	virtual void ResetFromPool(const FTransform& transform, EItemRarity rarity);
+
+	// Hides the item with no collision, ticking, timers or registrations until it is reset
+	virtual void ReturnToPool();
+
 	// Turn on Custom Depth postproccessing 
 	virtual void EnableCustomDepth();
 
@@ -140,6 +166,7 @@ public:
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type endPlayReason) override;
 
 	// Called when overlapping area sphere
 	UFUNCTION()
@@ -157,11 +184,8 @@ protected:
 	virtual void SetItemProperties(EItemState state);
 	void FinishInterping();
 
-	// Handles item interpolation
-	void ItemInterp(float deltaTime);
-
-	// Get interp location based on item type
-	FVector GetInterpLocation();
+	// Which of the characters interp locations this item flies to, based on item type
+	int32 GetInterpLocationIndex() const;
 
 	void PlayPickupSound(bool bForcePlaySound = false);
 
@@ -169,12 +193,25 @@ protected:
 
 	virtual void OnConstruction(const FTransform& transform) override;
 
-	void ResetPulseTimer();
-
-	void UpdatePulse();
+	// Hands the glow pulse for the current state to the pulse subsystem, or stops it
+	void RefreshPulse();
 
-	UDataTable* GetRarityDataTable();
 	void SetRarityData();
+
+	// True while something on the item needs updating every frame
+	virtual bool WantsTick() const;
+
+	// Swaps in the streaming placeholder mesh until the items own mesh has loaded
+	void ShowPlaceholderMesh();
+
+	// Adds the item to the pickup registry while it is in the pickup state and removes it otherwise
+	void RefreshPickupRegistration();
+
+	// Range at which characters pick the item up on their own, 0 means they have to select it
+	virtual float GetAutoPickupRadius() const;
+
+	// True when proximity comes from the pickup registry rather than the overlap spheres
+	FORCEINLINE bool UsesPickupRegistry() const { return bUsePickupRegistry; }
 private:	
 	
 	// Items skeletal mesh
@@ -185,14 +222,13 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
 	UBoxComponent* boxCollision;
 
-	// Popup widdget for when looks at item
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
-	UWidgetComponent* pickupWidget;
-
-	// Enables item tracing when overlapped
+	// Enables item tracing when overlapped, with the pickup registry only its radius is used
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
 	USphereComponent* areaSphere;
 
+	// Decided when play begins so an item never mixes the two proximity paths
+	bool bUsePickupRegistry = false;
+
 	// Name which appears on item
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
 	FString itemName = "Default";
@@ -287,9 +323,7 @@ private:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Item Properties|Curves", meta = (AllowPrivateAccess = "true"))
 	UCurveVector* interpPulseCurve;
 
-	FTimerHandle pulseTimer;
-
-	// Time for the pulse timer
+	// Seconds before the pickup pulse loops
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Item Properties|Curves", meta = (AllowPrivateAccess = "true"))
 	float pulseCurveTime = 5.f;
 
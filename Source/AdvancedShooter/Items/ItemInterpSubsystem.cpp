@@ -0,0 +1,192 @@
+#include "ItemInterpSubsystem.h"
+#include <AdvancedShooter/AdvancedShooter.h>
+#include <AdvancedShooter/Items/Item.h>
+#include <AdvancedShooter/ShooterCharacter.h>
+#include "Camera/CameraComponent.h"
+#include <Curves/CurveFloat.h>
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("Item Interp Update"), STAT_ItemInterpUpdate, STATGROUP_AdvancedShooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Interping Items"), STAT_InterpingItems, STATGROUP_AdvancedShooter);
+
+bool UItemInterpSubsystem::DoesSupportWorldType(EWorldType::Type worldType) const
+{
+	return worldType == EWorldType::Game || worldType == EWorldType::PIE;
+}
+
+void UItemInterpSubsystem::Deinitialize()
+{
+	items.Empty();
+	itemKeys.Empty();
+	characters.Empty();
+	interpLocationIndices.Empty();
+	zCurves.Empty();
+	scaleCurves.Empty();
+	startLocations.Empty();
+	currentLocations.Empty();
+	startTimes.Empty();
+	yawOffsets.Empty();
+	itemToIndex.Empty();
+
+	Super::Deinitialize();
+}
+
+TStatId UItemInterpSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UItemInterpSubsystem, STATGROUP_Tickables);
+}
+
+void UItemInterpSubsystem::AddItem(AItem* item, const FItemInterpParams& params)
+{
+	if (!item || !params.character) return;
+
+	// Picked up again before the last flight finished
+	RemoveItem(item);
+
+	const FObjectKey itemKey(item);
+	itemToIndex.Add(itemKey, items.Num());
+
+	items.Add(item);
+	itemKeys.Add(itemKey);
+	characters.Add(params.character);
+	interpLocationIndices.Add(params.interpLocationIndex);
+	zCurves.Add(params.zCurve);
+	scaleCurves.Add(params.scaleCurve);
+	startLocations.Add(params.startLocation);
+	currentLocations.Add(params.startLocation);
+	startTimes.Add(GetWorld()->GetTimeSeconds());
+	yawOffsets.Add(params.yawOffset);
+}
+
+void UItemInterpSubsystem::RemoveItem(AItem* item)
+{
+	const int32* index = itemToIndex.Find(FObjectKey(item));
+	if (!index) return;
+
+	RemoveAtSwap(*index);
+}
+
+void UItemInterpSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ItemInterpUpdate);
+
+	// Destroyed items and characters first so every pass below can trust the arrays
+	for (int32 i = items.Num() - 1; i >= 0; --i)
+	{
+		if (items[i].IsValid() && characters[i].IsValid()) continue;
+		RemoveAtSwap(i);
+	}
+
+	SET_DWORD_STAT(STAT_InterpingItems, items.Num());
+
+	const int32 count = items.Num();
+	if (count == 0) return;
+
+	GatherTargets();
+
+	const float worldTime = GetWorld()->GetTimeSeconds();
+
+	zValues.SetNumUninitialized(count, false);
+	scaleValues.SetNumUninitialized(count, false);
+
+	for (int32 i = 0; i < count; ++i)
+	{
+		const float elapsedTime = worldTime - startTimes[i];
+		zValues[i] = zCurves[i] ? zCurves[i]->GetFloatValue(elapsedTime) : 0.f;
+		scaleValues[i] = scaleCurves[i] ? scaleCurves[i]->GetFloatValue(elapsedTime) : 1.f;
+	}
+
+	for (int32 i = 0; i < count; ++i)
+	{
+		const FVector& startLocation = startLocations[i];
+		const FVector& targetLocation = targetLocations[i];
+
+		// X and Y ease toward the target, Z follows the curve scaled by the height to climb
+		FVector itemLocation = startLocation;
+		itemLocation.X = FMath::FInterpTo(currentLocations[i].X, targetLocation.X, DeltaTime, 30.f);
+		itemLocation.Y = FMath::FInterpTo(currentLocations[i].Y, targetLocation.Y, DeltaTime, 30.f);
+		itemLocation.Z += zValues[i] * FMath::Abs(targetLocation.Z - startLocation.Z);
+
+		currentLocations[i] = itemLocation;
+
+		const FTransform itemTransform(FRotator(0.f, targetYaws[i] + yawOffsets[i], 0.f), itemLocation, FVector(scaleValues[i]));
+
+		USceneComponent* rootComponent = items[i]->GetRootComponent();
+		if (!rootComponent) continue;
+
+		rootComponent->SetWorldTransform(itemTransform, false, NULL, ETeleportType::TeleportPhysics);
+	}
+}
+
+void UItemInterpSubsystem::GatherTargets()
+{
+	const int32 count = items.Num();
+
+	targetLocations.SetNumUninitialized(count, false);
+	targetYaws.SetNumUninitialized(count, false);
+
+	// Usually one character and a handful of interp locations, so a linear search beats hashing
+	TArray<TPair<AShooterCharacter*, float>, TInlineAllocator<4>> cameraYaws;
+	TArray<TPair<TPair<AShooterCharacter*, int32>, FVector>, TInlineAllocator<8>> interpLocations;
+
+	for (int32 i = 0; i < count; ++i)
+	{
+		AShooterCharacter* character = characters[i].Get();
+
+		const TPair<AShooterCharacter*, float>* cameraYaw = cameraYaws.FindByPredicate(
+			[character](const TPair<AShooterCharacter*, float>& entry) { return entry.Key == character; });
+
+		if (!cameraYaw)
+		{
+			const float yaw = character->GetFollowCamera()->GetComponentRotation().Yaw;
+			cameraYaw = &cameraYaws.Emplace_GetRef(character, yaw);
+		}
+
+		targetYaws[i] = cameraYaw->Value;
+
+		const TPair<AShooterCharacter*, int32> locationKey(character, interpLocationIndices[i]);
+
+		const TPair<TPair<AShooterCharacter*, int32>, FVector>* interpLocation = interpLocations.FindByPredicate(
+			[&locationKey](const TPair<TPair<AShooterCharacter*, int32>, FVector>& entry) { return entry.Key == locationKey; });
+
+		if (!interpLocation)
+		{
+			FVector location = FVector::ZeroVector;
+
+			if (locationKey.Value != INDEX_NONE)
+			{
+				location = character->GetInterpLocation(locationKey.Value).sceneComp->GetComponentLocation();
+			}
+
+			interpLocation = &interpLocations.Emplace_GetRef(locationKey, location);
+		}
+
+		targetLocations[i] = interpLocation->Value;
+	}
+}
+
+void UItemInterpSubsystem::RemoveAtSwap(int32 index)
+{
+	if (!items.IsValidIndex(index)) return;
+
+	const int32 lastIndex = items.Num() - 1;
+
+	itemToIndex.Remove(itemKeys[index]);
+
+	// Last item moves into the freed slot
+	if (index != lastIndex)
+	{
+		itemToIndex.Add(itemKeys[lastIndex], index);
+	}
+
+	items.RemoveAtSwap(index, 1, false);
+	itemKeys.RemoveAtSwap(index, 1, false);
+	characters.RemoveAtSwap(index, 1, false);
+	interpLocationIndices.RemoveAtSwap(index, 1, false);
+	zCurves.RemoveAtSwap(index, 1, false);
+	scaleCurves.RemoveAtSwap(index, 1, false);
+	startLocations.RemoveAtSwap(index, 1, false);
+	currentLocations.RemoveAtSwap(index, 1, false);
+	startTimes.RemoveAtSwap(index, 1, false);
+	yawOffsets.RemoveAtSwap(index, 1, false);
+}
@@ -0,0 +1,81 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "ItemInterpSubsystem.generated.h"
+
+class AItem;
+class AShooterCharacter;
+class UCurveFloat;
+
+// Everything an item needs to fly to the camera once it is picked up
+struct FItemInterpParams
+{
+	AShooterCharacter* character = NULL;
+
+	// Which of the characters interp locations to fly to, INDEX_NONE flies to the origin
+	int32 interpLocationIndex = INDEX_NONE;
+
+	// Height over the flight, scaled by the height difference to the target
+	const UCurveFloat* zCurve = NULL;
+	const UCurveFloat* scaleCurve = NULL;
+
+	FVector startLocation = FVector::ZeroVector;
+
+	// Item yaw relative to the camera when the pickup started
+	float yawOffset = 0.f;
+};
+
+/*
+Moves every item that is flying to the camera in one tick. In flight items are kept in parallel arrays,
+each characters camera and interp locations are read once per frame, the curves for all items are
+evaluated in one loop, and each item gets a single teleporting transform write with no sweep.
+*/
+UCLASS()
+class ADVANCEDSHOOTER_API UItemInterpSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void AddItem(AItem* item, const FItemInterpParams& params);
+	void RemoveItem(AItem* item);
+
+	int32 GetNumItems() const { return items.Num(); }
+
+protected:
+	virtual bool DoesSupportWorldType(EWorldType::Type worldType) const override;
+
+private:
+	void RemoveAtSwap(int32 index);
+
+	// Camera yaw and interp locations of each character with items in flight, read once per tick
+	void GatherTargets();
+
+	// IN FLIGHT ARRAYS, one entry per item at the same index
+	TArray<TWeakObjectPtr<AItem>> items;
+	TArray<FObjectKey> itemKeys;
+	TArray<TWeakObjectPtr<AShooterCharacter>> characters;
+	TArray<int32> interpLocationIndices;
+	TArray<const UCurveFloat*> zCurves;
+	TArray<const UCurveFloat*> scaleCurves;
+	TArray<FVector> startLocations;
+	TArray<FVector> currentLocations;
+	TArray<float> startTimes;
+	TArray<float> yawOffsets;
+
+	// Per tick scratch
+	TArray<FVector> targetLocations;
+	TArray<float> targetYaws;
+	TArray<float> zValues;
+	TArray<float> scaleValues;
+
+	// Item to its index in the arrays
+	TMap<FObjectKey, int32> itemToIndex;
+};
@@ -0,0 +1,243 @@
+#include "ItemPoolSubsystem.h"
+#include <AdvancedShooter/AdvancedShooter.h>
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Item Pool Hits"), STAT_ItemPoolHits, STATGROUP_AdvancedShooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Item Pool Misses"), STAT_ItemPoolMisses, STATGROUP_AdvancedShooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Item Pool Dormant"), STAT_ItemPoolDormant, STATGROUP_AdvancedShooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Item Pool Active"), STAT_ItemPoolActive, STATGROUP_AdvancedShooter);
+
+static FAutoConsoleCommandWithWorld DumpItemPoolsCommand(
+	TEXT("Shooter.ItemPool.Dump"),
+	TEXT("Logs hits, misses and peak usage for every item pool in the world."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* world)
+	{
+		if (!world) return;
+
+		const UItemPoolSubsystem* itemPool = world->GetSubsystem<UItemPoolSubsystem>();
+		if (!itemPool) return;
+
+		itemPool->LogPoolStats();
+	}));
+
+bool UItemPoolSubsystem::DoesSupportWorldType(EWorldType::Type worldType) const
+{
+	return worldType == EWorldType::Game || worldType == EWorldType::PIE;
+}
+
+void UItemPoolSubsystem::OnWorldBeginPlay(UWorld& world)
+{
+	Super::OnWorldBeginPlay(world);
+
+	for (const FItemPoolWarmup& warmup : warmupPools)
+	{
+		// Level load is the place to take the hit of loading the class
+		WarmUp(warmup.itemClass.LoadSynchronous(), warmup.row, warmup.count);
+	}
+}
+
+void UItemPoolSubsystem::Deinitialize()
+{
+	LogPoolStats();
+
+	// Dormant items are level actors and go with the world, only the bookkeeping needs clearing
+	pools.Empty();
+	activeItems.Empty();
+
+	SET_DWORD_STAT(STAT_ItemPoolDormant, 0);
+	SET_DWORD_STAT(STAT_ItemPoolActive, 0);
+
+	Super::Deinitialize();
+}
+
+AItem* UItemPoolSubsystem::AcquirePooledItem(const UObject* worldContext, TSubclassOf<AItem> itemClass, int32 row, const FTransform& transform, EItemRarity rarity)
+{
+	if (!worldContext || !itemClass) return NULL;
+
+	UWorld* world = worldContext->GetWorld();
+	if (!world) return NULL;
+
+	UItemPoolSubsystem* itemPool = world->GetSubsystem<UItemPoolSubsystem>();
+	if (itemPool) return itemPool->AcquireItem(itemClass, row, transform, rarity);
+
+	AItem* item = world->SpawnActorDeferred<AItem>(itemClass, transform);
+	if (!item) return NULL;
+
+	if (row != INDEX_NONE) item->SetPoolRow(static_cast<uint8>(row));
+	item->FinishSpawning(transform);
+
+	return item;
+}
+
+void UItemPoolSubsystem::ReleasePooledItem(AItem* item)
+{
+	if (!item) return;
+
+	UItemPoolSubsystem* itemPool = item->GetWorld() ? item->GetWorld()->GetSubsystem<UItemPoolSubsystem>() : NULL;
+
+	if (!itemPool)
+	{
+		item->Destroy();
+		return;
+	}
+
+	itemPool->ReleaseItem(item);
+}
+
+FItemPoolKey UItemPoolSubsystem::MakeKey(TSubclassOf<AItem> itemClass, int32 row)
+{
+	FItemPoolKey key;
+	key.itemClass = itemClass;
+	key.row = row != INDEX_NONE ? static_cast<uint8>(row) : itemClass->GetDefaultObject<AItem>()->GetPoolRow();
+
+	return key;
+}
+
+AItem* UItemPoolSubsystem::AcquireItem(TSubclassOf<AItem> itemClass, int32 row, const FTransform& transform, EItemRarity rarity)
+{
+	if (!itemClass) return NULL;
+
+	const FItemPoolKey key = MakeKey(itemClass, row);
+	FItemPool& pool = pools.FindOrAdd(key);
+
+	AItem* item = NULL;
+
+	// Anything destroyed while dormant, eg by a level script, is skipped
+	while (!item && pool.freeItems.Num() > 0)
+	{
+		item = pool.freeItems.Pop(false);
+		DEC_DWORD_STAT(STAT_ItemPoolDormant);
+
+		if (!IsValid(item)) item = NULL;
+	}
+
+	if (item)
+	{
+		INC_DWORD_STAT(STAT_ItemPoolHits);
+		++pool.stats.hits;
+
+		item->ResetFromPool(transform, rarity);
+	}
+
+	else
+	{
+		INC_DWORD_STAT(STAT_ItemPoolMisses);
+		++pool.stats.misses;
+
+		item = SpawnPooledItem(key, transform, false);
+		if (!item) return NULL;
+
+		if (rarity != EItemRarity::EIR_MAX) item->ResetFromPool(transform, rarity);
+	}
+
+	activeItems.Add(FObjectKey(item), key);
+	INC_DWORD_STAT(STAT_ItemPoolActive);
+
+	++pool.activeCount;
+	pool.stats.peakActive = FMath::Max(pool.stats.peakActive, pool.activeCount);
+
+	return item;
+}
+
+void UItemPoolSubsystem::ReleaseItem(AItem* item)
+{
+	if (!item) return;
+
+	FItemPoolKey key;
+
+	// Not ours, eg placed in the level
+	if (!activeItems.RemoveAndCopyValue(FObjectKey(item), key))
+	{
+		item->Destroy();
+		return;
+	}
+
+	DEC_DWORD_STAT(STAT_ItemPoolActive);
+
+	FItemPool& pool = pools.FindOrAdd(key);
+	pool.activeCount = FMath::Max(pool.activeCount - 1, 0);
+	++pool.stats.releases;
+
+	if (pool.freeItems.Num() >= maxPoolSize)
+	{
+		++pool.stats.overflows;
+		item->Destroy();
+		return;
+	}
+
+	item->ReturnToPool();
+
+	pool.freeItems.Add(item);
+	INC_DWORD_STAT(STAT_ItemPoolDormant);
+}
+
+void UItemPoolSubsystem::ForgetItem(AItem* item)
+{
+	FItemPoolKey key;
+	if (!activeItems.RemoveAndCopyValue(FObjectKey(item), key)) return;
+
+	DEC_DWORD_STAT(STAT_ItemPoolActive);
+
+	FItemPool* pool = pools.Find(key);
+	if (!pool) return;
+
+	pool->activeCount = FMath::Max(pool->activeCount - 1, 0);
+}
+
+void UItemPoolSubsystem::WarmUp(TSubclassOf<AItem> itemClass, int32 row, int32 count)
+{
+	if (!itemClass) return;
+
+	const FItemPoolKey key = MakeKey(itemClass, row);
+	FItemPool& pool = pools.FindOrAdd(key);
+
+	const int32 toSpawn = FMath::Min(count, maxPoolSize) - pool.freeItems.Num();
+
+	for (int32 i = 0; i < toSpawn; ++i)
+	{
+		AItem* item = SpawnPooledItem(key, FTransform::Identity, true);
+		if (!item) break;
+
+		pool.freeItems.Add(item);
+		INC_DWORD_STAT(STAT_ItemPoolDormant);
+	}
+}
+
+AItem* UItemPoolSubsystem::SpawnPooledItem(const FItemPoolKey& key, const FTransform& transform, bool bDormant)
+{
+	UWorld* world = GetWorld();
+	if (!world) return NULL;
+
+	AItem* item = world->SpawnActorDeferred<AItem>(key.itemClass, transform, NULL, NULL, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+	if (!item) return NULL;
+
+	// Construction reads the row, so it has to be set first
+	item->SetPoolRow(key.row);
+	item->FinishSpawning(transform);
+
+	if (bDormant) item->ReturnToPool();
+
+	return item;
+}
+
+FItemPoolStats UItemPoolSubsystem::GetPoolStats(TSubclassOf<AItem> itemClass, int32 row) const
+{
+	if (!itemClass) return FItemPoolStats();
+
+	const FItemPool* pool = pools.Find(MakeKey(itemClass, row));
+	return pool ? pool->stats : FItemPoolStats();
+}
+
+void UItemPoolSubsystem::LogPoolStats() const
+{
+	for (const TPair<FItemPoolKey, FItemPool>& poolPair : pools)
+	{
+		const FItemPoolStats& stats = poolPair.Value.stats;
+
+		UE_LOG(LogTemp, Log, TEXT("Item pool %s row %d: dormant %d, active %d, hits %d, misses %d, releases %d (destroyed %d), peak %d"),
+			*GetNameSafe(poolPair.Key.itemClass), poolPair.Key.row,
+			poolPair.Value.freeItems.Num(), poolPair.Value.activeCount,
+			stats.hits, stats.misses, stats.releases, stats.overflows, stats.peakActive);
+	}
+}
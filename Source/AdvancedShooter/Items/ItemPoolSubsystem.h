@@ -0,0 +1,142 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include <AdvancedShooter/Items/Item.h>
+#include "ItemPoolSubsystem.generated.h"
+
+// Items are only interchangeable when they share a class and a data table row, eg a weapon type or ammo type
+USTRUCT()
+struct FItemPoolKey
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	UClass* itemClass = NULL;
+
+	UPROPERTY()
+	uint8 row = 0;
+
+	bool operator==(const FItemPoolKey& other) const { return itemClass == other.itemClass && row == other.row; }
+
+	friend uint32 GetTypeHash(const FItemPoolKey& key) { return HashCombine(GetTypeHash(key.itemClass), GetTypeHash(key.row)); }
+};
+
+USTRUCT(BlueprintType)
+struct FItemPoolStats
+{
+	GENERATED_BODY()
+
+	// Acquires served by a dormant item
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 hits = 0;
+
+	// Acquires that had to spawn a new item
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 misses = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 releases = 0;
+
+	// Releases destroyed because the pool was full
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 overflows = 0;
+
+	// Most items out of the pool at once
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 peakActive = 0;
+};
+
+USTRUCT()
+struct FItemPool
+{
+	GENERATED_BODY()
+
+	// Dormant items ready to be acquired
+	UPROPERTY()
+	TArray<AItem*> freeItems;
+
+	int32 activeCount = 0;
+
+	FItemPoolStats stats;
+};
+
+// A pool to fill when the level loads, set in DefaultGame.ini
+USTRUCT()
+struct FItemPoolWarmup
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TSoftClassPtr<AItem> itemClass;
+
+	// INDEX_NONE uses the row of the class defaults
+	UPROPERTY()
+	int32 row = INDEX_NONE;
+
+	UPROPERTY()
+	int32 count = 0;
+};
+
+/*
+Keeps dormant weapons and ammo per class and row and hands them back out instead of spawning a new actor,
+registering its components and creating its dynamic material every time loot appears.
+Acquired items are reset to a fresh pickup at the requested transform and rarity, released items are hidden
+with no collision until they are needed again. Warm up pools and the pool cap are set in the
+[/Script/AdvancedShooter.ItemPoolSubsystem] section of DefaultGame.ini.
+*/
+UCLASS(Config = Game)
+class ADVANCEDSHOOTER_API UItemPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void OnWorldBeginPlay(UWorld& world) override;
+	virtual void Deinitialize() override;
+
+	// A pickup of the class and row, row INDEX_NONE uses the class defaults and rarity EIR_MAX keeps the items own
+	AItem* AcquireItem(TSubclassOf<AItem> itemClass, int32 row, const FTransform& transform, EItemRarity rarity = EItemRarity::EIR_MAX);
+
+	// Returns an item from AcquireItem to its pool, anything else is destroyed
+	void ReleaseItem(AItem* item);
+
+	// Stops tracking an item from AcquireItem that was destroyed instead of released
+	void ForgetItem(AItem* item);
+
+	// Spawns dormant items up front so loot appearing mid game doesnt pay for them
+	void WarmUp(TSubclassOf<AItem> itemClass, int32 row, int32 count);
+
+	// Go through the worlds pool, falling back to spawning and destroying when there is none (editor worlds)
+	static AItem* AcquirePooledItem(const UObject* worldContext, TSubclassOf<AItem> itemClass, int32 row, const FTransform& transform, EItemRarity rarity = EItemRarity::EIR_MAX);
+	static void ReleasePooledItem(AItem* item);
+
+	FItemPoolStats GetPoolStats(TSubclassOf<AItem> itemClass, int32 row) const;
+
+	// Writes the stats for every pool to the log
+	void LogPoolStats() const;
+
+protected:
+	virtual bool DoesSupportWorldType(EWorldType::Type worldType) const override;
+
+private:
+	static FItemPoolKey MakeKey(TSubclassOf<AItem> itemClass, int32 row);
+
+	// Spawns an item already set up for the row, dormant when bDormant
+	AItem* SpawnPooledItem(const FItemPoolKey& key, const FTransform& transform, bool bDormant);
+
+	UPROPERTY()
+	TMap<FItemPoolKey, FItemPool> pools;
+
+	// Items out of their pool, for finding the pool on release
+	TMap<FObjectKey, FItemPoolKey> activeItems;
+
+	// Released items past this many in one pool are destroyed instead
+	UPROPERTY(Config)
+	int32 maxPoolSize = 64;
+
+	UPROPERTY(Config)
+	TArray<FItemPoolWarmup> warmupPools;
+};
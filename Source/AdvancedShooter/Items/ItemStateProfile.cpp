@@ -0,0 +1,129 @@
+#include "ItemStateProfile.h"
+#include <AdvancedShooter/AdvancedShooter.h>
+#include "Components/PrimitiveComponent.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Item Components Updated"), STAT_ItemComponentsUpdated, STATGROUP_AdvancedShooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Item Components Unchanged"), STAT_ItemComponentsUnchanged, STATGROUP_AdvancedShooter);
+
+static TStaticArray<FItemStateProfile, static_cast<int32>(EItemState::EIS_MAX)> BuildItemStateProfiles()
+{
+	FItemCollisionProfile noCollision;
+
+	FItemCollisionProfile heldMesh = noCollision;
+	heldMesh.bApplyPhysics = true;
+
+	// Falls under physics and only lands on the level
+	FItemCollisionProfile fallingMesh = heldMesh;
+	fallingMesh.collisionEnabled = ECollisionEnabled::QueryAndPhysics;
+	fallingMesh.responses.SetResponse(ECollisionChannel::ECC_WorldStatic, ECollisionResponse::ECR_Block);
+	fallingMesh.bSimulatePhysics = true;
+	fallingMesh.bEnableGravity = true;
+
+	FItemCollisionProfile pickupAreaSphere;
+	pickupAreaSphere.collisionEnabled = ECollisionEnabled::QueryOnly;
+	pickupAreaSphere.responses = FCollisionResponseContainer(ECollisionResponse::ECR_Overlap);
+
+	// Only the crosshair trace hits it
+	FItemCollisionProfile pickupBox;
+	pickupBox.collisionEnabled = ECollisionEnabled::QueryAndPhysics;
+	pickupBox.responses.SetResponse(ECollisionChannel::ECC_Visibility, ECollisionResponse::ECR_Block);
+
+	TStaticArray<FItemStateProfile, static_cast<int32>(EItemState::EIS_MAX)> profiles;
+
+	FItemStateProfile& pickup = profiles[static_cast<int32>(EItemState::EIS_Pickup)];
+	pickup.mesh = heldMesh;
+	pickup.areaSphere = pickupAreaSphere;
+	pickup.boxCollision = pickupBox;
+
+	FItemStateProfile& equipInterping = profiles[static_cast<int32>(EItemState::EIS_EquipInterping)];
+	equipInterping.mesh = heldMesh;
+	equipInterping.areaSphere = noCollision;
+	equipInterping.boxCollision = noCollision;
+
+	FItemStateProfile& pickedUp = profiles[static_cast<int32>(EItemState::EIS_PickedUp)];
+	pickedUp.mesh = heldMesh;
+	pickedUp.areaSphere = noCollision;
+	pickedUp.boxCollision = noCollision;
+	pickedUp.bMeshVisible = false;
+
+	FItemStateProfile& equipped = profiles[static_cast<int32>(EItemState::EIS_Equipped)];
+	equipped.mesh = heldMesh;
+	equipped.areaSphere = noCollision;
+	equipped.boxCollision = noCollision;
+
+	FItemStateProfile& falling = profiles[static_cast<int32>(EItemState::EIS_Falling)];
+	falling.mesh = fallingMesh;
+	falling.areaSphere = noCollision;
+	falling.boxCollision = noCollision;
+
+	return profiles;
+}
+
+const FItemStateProfile& FItemStateProfile::Get(EItemState state)
+{
+	static const TStaticArray<FItemStateProfile, static_cast<int32>(EItemState::EIS_MAX)> profiles = BuildItemStateProfiles();
+
+	check(state < EItemState::EIS_MAX);
+	return profiles[static_cast<int32>(state)];
+}
+
+bool FItemCollisionProfile::Apply(UPrimitiveComponent* component) const
+{
+	if (!component) return false;
+
+	bool bChanged = false;
+
+	// Stop simulating before collision goes away, start again only once collision is back
+	if (bApplyPhysics && !bSimulatePhysics && component->BodyInstance.bSimulatePhysics)
+	{
+		component->SetSimulatePhysics(false);
+		bChanged = true;
+	}
+
+	if (!(component->GetCollisionResponseToChannels() == responses))
+	{
+		// Every channel in one physics filter update
+		component->SetCollisionResponseToChannels(responses);
+		bChanged = true;
+	}
+
+	// The components own setting, GetCollisionEnabled reports NoCollision whenever the owning actor has collision off,
+	// eg hidden or pooled items, which would skip real changes and leave them wrong once the actor collides again
+	if (component->BodyInstance.GetCollisionEnabled(false) != collisionEnabled)
+	{
+		component->SetCollisionEnabled(collisionEnabled);
+		bChanged = true;
+	}
+
+	if (bApplyPhysics && component->BodyInstance.bEnableGravity != bEnableGravity)
+	{
+		component->SetEnableGravity(bEnableGravity);
+		bChanged = true;
+	}
+
+	if (bApplyPhysics && bSimulatePhysics && !component->BodyInstance.bSimulatePhysics)
+	{
+		component->SetSimulatePhysics(true);
+		bChanged = true;
+	}
+
+	if (bChanged) INC_DWORD_STAT(STAT_ItemComponentsUpdated);
+	else INC_DWORD_STAT(STAT_ItemComponentsUnchanged);
+
+	return bChanged;
+}
+
+bool FItemStateProfile::ApplyToMesh(UPrimitiveComponent* component) const
+{
+	if (!component) return false;
+
+	bool bChanged = mesh.Apply(component);
+
+	if (component->IsVisible() != bMeshVisible)
+	{
+		component->SetVisibility(bMeshVisible);
+		bChanged = true;
+	}
+
+	return bChanged;
+}
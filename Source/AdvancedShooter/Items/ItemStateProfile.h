@@ -0,0 +1,43 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include <AdvancedShooter/Items/Item.h>
+
+class UPrimitiveComponent;
+
+// Full collision and physics setup of one item component
+struct FItemCollisionProfile
+{
+	ECollisionEnabled::Type collisionEnabled = ECollisionEnabled::NoCollision;
+
+	FCollisionResponseContainer responses = FCollisionResponseContainer(ECollisionResponse::ECR_Ignore);
+
+	// Overlap and trace only components keep whatever physics flags they were built with
+	bool bApplyPhysics = false;
+	bool bSimulatePhysics = false;
+	bool bEnableGravity = false;
+
+	// Only touches what differs from the components current setup, returns true if anything did
+	bool Apply(UPrimitiveComponent* component) const;
+};
+
+/*
+How every component of an item is set up in one item state. Built once per state so a state change is a
+lookup and a compare per component rather than a string of setters that each rebuild physics state.
+*/
+struct FItemStateProfile
+{
+	FItemCollisionProfile mesh;
+	FItemCollisionProfile areaSphere;
+	FItemCollisionProfile boxCollision;
+
+	bool bMeshVisible = true;
+
+	// Collision profile plus visibility, for the item mesh and any extra meshes a subclass adds
+	bool ApplyToMesh(UPrimitiveComponent* component) const;
+
+	static const FItemStateProfile& Get(EItemState state);
+};
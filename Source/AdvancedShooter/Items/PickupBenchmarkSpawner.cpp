@@ -0,0 +1,151 @@
+#include "PickupBenchmarkSpawner.h"
+#include <AdvancedShooter/AdvancedShooter.h>
+#include <AdvancedShooter/Items/Ammo.h>
+#include <AdvancedShooter/Items/PickupRegistrySubsystem.h>
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+
+static FAutoConsoleCommandWithWorldAndArgs PickupBenchmarkCommand(
+	TEXT("Shooter.Pickups.Benchmark"),
+	TEXT("Spawns a pickup benchmark at the player, optionally followed by the item counts to run, eg Shooter.Pickups.Benchmark 1000 5000 10000."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& args, UWorld* world)
+	{
+		if (!world) return;
+
+		const APlayerController* playerController = world->GetFirstPlayerController();
+		const APawn* pawn = playerController ? playerController->GetPawn() : NULL;
+		if (!pawn) return;
+
+		TArray<int32> counts;
+		for (const FString& arg : args)
+		{
+			const int32 count = FCString::Atoi(*arg);
+			if (count > 0) counts.Add(count);
+		}
+
+		const FTransform spawnTransform(pawn->GetActorLocation() - FVector(0.f, 0.f, pawn->GetDefaultHalfHeight()));
+
+		APickupBenchmarkSpawner* spawner = world->SpawnActorDeferred<APickupBenchmarkSpawner>(APickupBenchmarkSpawner::StaticClass(), spawnTransform);
+		if (!spawner) return;
+
+		if (counts.Num() > 0) spawner->SetItemCounts(counts);
+		spawner->FinishSpawning(spawnTransform);
+	}));
+
+// Sets default values
+APickupBenchmarkSpawner::APickupBenchmarkSpawner()
+{
+	PrimaryActorTick.bCanEverTick = true;
+
+	itemClass = AAmmo::StaticClass();
+	itemCounts = { 1000, 5000, 10000 };
+}
+
+// Called when the game starts or when spawned
+void APickupBenchmarkSpawner::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (!itemClass || itemCounts.Num() == 0) return;
+
+	bWasSpatialHashEnabled = UPickupRegistrySubsystem::IsSpatialHashEnabled();
+
+	stepIndex = 0;
+	StartStep();
+}
+
+void APickupBenchmarkSpawner::EndPlay(const EEndPlayReason::Type endPlayReason)
+{
+	DestroyItems();
+
+	// Stopped part way through
+	if (stepIndex != INDEX_NONE) UPickupRegistrySubsystem::SetSpatialHashEnabled(bWasSpatialHashEnabled);
+
+	Super::EndPlay(endPlayReason);
+}
+
+// Called every frame
+void APickupBenchmarkSpawner::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (stepIndex == INDEX_NONE) return;
+
+	stepTime += DeltaTime;
+	if (stepTime < warmupTime) return;
+
+	frameTimeSum += DeltaTime;
+	worstFrameTime = FMath::Max(worstFrameTime, DeltaTime);
+	++frameCount;
+
+	if (stepTime < warmupTime + sampleTime) return;
+
+	FinishStep();
+}
+
+void APickupBenchmarkSpawner::StartStep()
+{
+	const int32 itemCount = itemCounts[stepIndex / 2];
+	const bool bUseSpatialHash = stepIndex % 2 == 0;
+
+	// Items pick the proximity path as they begin play, so this has to be set before spawning
+	UPickupRegistrySubsystem::SetSpatialHashEnabled(bUseSpatialHash);
+
+	const int32 side = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(itemCount)));
+	const FVector corner = GetActorLocation() - FVector(side * itemSpacing * 0.5f, side * itemSpacing * 0.5f, 0.f);
+
+	FActorSpawnParameters spawnParams;
+	spawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	spawnedItems.Reserve(itemCount);
+
+	for (int32 i = 0; i < itemCount; ++i)
+	{
+		const FVector location = corner + FVector((i % side) * itemSpacing, (i / side) * itemSpacing, 0.f);
+
+		AItem* item = GetWorld()->SpawnActor<AItem>(itemClass, location, FRotator::ZeroRotator, spawnParams);
+		if (item) spawnedItems.Add(item);
+	}
+
+	stepTime = 0.f;
+	frameTimeSum = 0.0;
+	worstFrameTime = 0.f;
+	frameCount = 0;
+}
+
+void APickupBenchmarkSpawner::FinishStep()
+{
+	const int32 itemCount = itemCounts[stepIndex / 2];
+	const bool bUseSpatialHash = stepIndex % 2 == 0;
+
+	UE_LOG(LogTemp, Log, TEXT("Pickup benchmark %d items, %s: %.2f ms average, %.2f ms worst over %d frames"),
+		itemCount, bUseSpatialHash ? TEXT("pickup registry") : TEXT("overlap spheres"),
+		frameCount > 0 ? frameTimeSum / frameCount * 1000.0 : 0.0, worstFrameTime * 1000.f, frameCount);
+
+	DestroyItems();
+
+	++stepIndex;
+
+	if (stepIndex < itemCounts.Num() * 2)
+	{
+		StartStep();
+		return;
+	}
+
+	stepIndex = INDEX_NONE;
+	UPickupRegistrySubsystem::SetSpatialHashEnabled(bWasSpatialHashEnabled);
+}
+
+void APickupBenchmarkSpawner::DestroyItems()
+{
+	for (AItem* item : spawnedItems)
+	{
+		// Anything the player picked up during the run belongs to them now
+		if (!IsValid(item) || item->GetItemState() != EItemState::EIS_Pickup) continue;
+		item->Destroy();
+	}
+
+	spawnedItems.Reset();
+}
@@ -0,0 +1,75 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "PickupBenchmarkSpawner.generated.h"
+
+class AItem;
+
+/*
+Fills a square around itself with pickups and logs the average and worst frame time, once with the pickup
+registry and once with the overlap spheres, for each item count in turn. Drop one in a test map or run
+Shooter.Pickups.Benchmark to spawn one at the player. Run it with the player standing in the field so
+both paths are doing real work.
+*/
+UCLASS()
+class ADVANCEDSHOOTER_API APickupBenchmarkSpawner : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	// Sets default values for this actor's properties
+	APickupBenchmarkSpawner();
+
+	// Called every frame
+	virtual void Tick(float DeltaTime) override;
+
+	FORCEINLINE void SetItemCounts(const TArray<int32>& counts) { itemCounts = counts; }
+
+protected:
+	// Called when the game starts or when spawned
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type endPlayReason) override;
+
+private:
+	// Spawns the items for the current step, every count runs with the registry and then with the spheres
+	void StartStep();
+	void FinishStep();
+
+	void DestroyItems();
+
+	// Pickup spawned for the benchmark, ammo by default since it has both overlap spheres
+	UPROPERTY(EditAnywhere, Category = "Benchmark", meta = (AllowPrivateAccess = "true"))
+	TSubclassOf<AItem> itemClass;
+
+	UPROPERTY(EditAnywhere, Category = "Benchmark", meta = (AllowPrivateAccess = "true"))
+	TArray<int32> itemCounts;
+
+	// Distance between neighbouring items in the square
+	UPROPERTY(EditAnywhere, Category = "Benchmark", meta = (AllowPrivateAccess = "true"))
+	float itemSpacing = 150.f;
+
+	// Seconds after spawning before frames are measured, lets the spawn hitch pass
+	UPROPERTY(EditAnywhere, Category = "Benchmark", meta = (AllowPrivateAccess = "true"))
+	float warmupTime = 2.f;
+
+	// Seconds of frames measured per step
+	UPROPERTY(EditAnywhere, Category = "Benchmark", meta = (AllowPrivateAccess = "true"))
+	float sampleTime = 5.f;
+
+	UPROPERTY(Transient)
+	TArray<AItem*> spawnedItems;
+
+	// Two steps per item count, even steps use the registry and odd steps the spheres
+	int32 stepIndex = INDEX_NONE;
+
+	float stepTime = 0.f;
+	double frameTimeSum = 0.0;
+	float worstFrameTime = 0.f;
+	int32 frameCount = 0;
+
+	// Restored once the benchmark is done
+	bool bWasSpatialHashEnabled = true;
+};
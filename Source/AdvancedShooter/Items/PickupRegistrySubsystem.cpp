@@ -0,0 +1,112 @@
+#include "PickupRegistrySubsystem.h"
+#include <AdvancedShooter/AdvancedShooter.h>
+#include <AdvancedShooter/Items/Item.h>
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Pickup Query"), STAT_PickupQuery, STATGROUP_AdvancedShooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Registered Pickups"), STAT_RegisteredPickups, STATGROUP_AdvancedShooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pickups Queried"), STAT_PickupsQueried, STATGROUP_AdvancedShooter);
+
+static TAutoConsoleVariable<int32> CVarUseSpatialHash(
+	TEXT("Shooter.Pickups.UseSpatialHash"),
+	1,
+	TEXT("1: items in the pickup state are found through the pickup registry grid.\n")
+	TEXT("0: items use their area and ammo overlap spheres like before. Applies to items that begin play after the change."),
+	ECVF_Cheat);
+
+bool UPickupRegistrySubsystem::DoesSupportWorldType(EWorldType::Type worldType) const
+{
+	return worldType == EWorldType::Game || worldType == EWorldType::PIE;
+}
+
+void UPickupRegistrySubsystem::Initialize(FSubsystemCollectionBase& collection)
+{
+	Super::Initialize(collection);
+
+	grid.SetCellSize(cellSize);
+}
+
+void UPickupRegistrySubsystem::Deinitialize()
+{
+	grid.Reset();
+	pickups.Empty();
+
+	SET_DWORD_STAT(STAT_RegisteredPickups, 0);
+
+	Super::Deinitialize();
+}
+
+bool UPickupRegistrySubsystem::IsSpatialHashEnabled()
+{
+	return CVarUseSpatialHash.GetValueOnGameThread() != 0;
+}
+
+void UPickupRegistrySubsystem::SetSpatialHashEnabled(bool bEnabled)
+{
+	CVarUseSpatialHash->Set(bEnabled ? 1 : 0, ECVF_SetByCode);
+}
+
+void UPickupRegistrySubsystem::AddPickup(AItem* item, float pickupRadius, float autoPickupRadius)
+{
+	if (!item) return;
+
+	const FObjectKey itemKey(item);
+
+	FRegisteredPickup& pickup = pickups.FindOrAdd(itemKey);
+	pickup.item = item;
+	pickup.location = item->GetActorLocation();
+	pickup.pickupRadius = pickupRadius;
+	pickup.autoPickupRadius = autoPickupRadius;
+
+	// Never shrinks, an oversized search only costs a few extra distance checks
+	maxRadius = FMath::Max3(maxRadius, pickupRadius, autoPickupRadius);
+
+	grid.Add(itemKey, pickup.location);
+
+	SET_DWORD_STAT(STAT_RegisteredPickups, pickups.Num());
+}
+
+void UPickupRegistrySubsystem::RemovePickup(AItem* item)
+{
+	const FObjectKey itemKey(item);
+	if (!pickups.Remove(itemKey)) return;
+
+	grid.Remove(itemKey);
+
+	SET_DWORD_STAT(STAT_RegisteredPickups, pickups.Num());
+}
+
+int32 UPickupRegistrySubsystem::QueryPickups(const FVector& capsuleCenter, float capsuleRadius, float capsuleHalfHeight, TArray<AItem*>& outAutoPickups) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_PickupQuery);
+
+	// Line between the centers of the capsules end spheres
+	const FVector segmentOffset(0.f, 0.f, FMath::Max(capsuleHalfHeight - capsuleRadius, 0.f));
+	const FVector segmentStart = capsuleCenter - segmentOffset;
+	const FVector segmentEnd = capsuleCenter + segmentOffset;
+
+	queryResults.Reset();
+	grid.QuerySphere(capsuleCenter, maxRadius + FMath::Max(capsuleHalfHeight, capsuleRadius), queryResults);
+
+	INC_DWORD_STAT_BY(STAT_PickupsQueried, queryResults.Num());
+
+	int32 inRangeCount = 0;
+
+	for (const FObjectKey& itemKey : queryResults)
+	{
+		const FRegisteredPickup& pickup = pickups.FindChecked(itemKey);
+
+		// Destroyed without ending play, eg when the level is torn down
+		AItem* item = pickup.item.Get();
+		if (!item) continue;
+
+		// A sphere overlaps the capsule when its center is within both radii of the segment
+		const float distanceSquared = FVector::DistSquared(pickup.location, FMath::ClosestPointOnSegment(pickup.location, segmentStart, segmentEnd));
+
+		if (distanceSquared <= FMath::Square(pickup.pickupRadius + capsuleRadius)) ++inRangeCount;
+		if (pickup.autoPickupRadius > 0.f && distanceSquared <= FMath::Square(pickup.autoPickupRadius + capsuleRadius)) outAutoPickups.Add(item);
+	}
+
+	return inRangeCount;
+}
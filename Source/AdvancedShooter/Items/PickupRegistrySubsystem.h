@@ -0,0 +1,72 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include <AdvancedShooter/Items/SpatialHashGrid.h>
+#include "PickupRegistrySubsystem.generated.h"
+
+class AItem;
+
+// One item lying in the world waiting to be picked up
+struct FRegisteredPickup
+{
+	TWeakObjectPtr<AItem> item;
+
+	FVector location = FVector::ZeroVector;
+
+	// Characters closer than this trace for the item, same as the old area sphere radius
+	float pickupRadius = 0.f;
+
+	// Characters closer than this pick the item up without looking at it, 0 never does
+	float autoPickupRadius = 0.f;
+};
+
+/*
+Keeps every item in the pickup state in a uniform grid so characters find the ones near them with one
+query per tick, instead of each item carrying overlap spheres that the physics broadphase has to track.
+Items register when they enter the pickup state and leave it when they are picked up, fall or are destroyed.
+Cell size is set in the [/Script/AdvancedShooter.PickupRegistrySubsystem] section of DefaultGame.ini.
+*/
+UCLASS(Config = Game)
+class ADVANCEDSHOOTER_API UPickupRegistrySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& collection) override;
+	virtual void Deinitialize() override;
+
+	// False falls back to the overlap spheres, only read by items as they begin play
+	static bool IsSpatialHashEnabled();
+	static void SetSpatialHashEnabled(bool bEnabled);
+
+	void AddPickup(AItem* item, float pickupRadius, float autoPickupRadius);
+	void RemovePickup(AItem* item);
+
+	// Returns how many pickups are within their pickup radius of the capsule and adds the ones within their auto pickup radius,
+	// measured to the capsule surface like the overlap spheres were
+	int32 QueryPickups(const FVector& capsuleCenter, float capsuleRadius, float capsuleHalfHeight, TArray<AItem*>& outAutoPickups) const;
+
+	int32 GetNumPickups() const { return pickups.Num(); }
+
+protected:
+	virtual bool DoesSupportWorldType(EWorldType::Type worldType) const override;
+
+private:
+	// Width of a grid cell, around the largest pickup radius keeps a query to a few cells
+	UPROPERTY(Config)
+	float cellSize = 500.f;
+
+	TSpatialHashGrid<FObjectKey> grid;
+
+	TMap<FObjectKey, FRegisteredPickup> pickups;
+
+	// Largest radius of anything registered, queries search this far and then check each pickups own radius
+	float maxRadius = 0.f;
+
+	// Per query scratch
+	mutable TArray<FObjectKey> queryResults;
+};
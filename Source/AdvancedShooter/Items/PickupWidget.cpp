@@ -0,0 +1,65 @@
+#include "PickupWidget.h"
+#include <AdvancedShooter/AdvancedShooter.h>
+#include <AdvancedShooter/Items/Ammo.h>
+#include <AdvancedShooter/ShooterCharacter.h>
+#include <Components/WidgetComponent.h>
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+
+static FAutoConsoleCommandWithWorld PickupWidgetMemoryCommand(
+	TEXT("Shooter.Pickups.WidgetMemory"),
+	TEXT("Logs the memory of the shared pickup widget next to an estimate of what one widget component per item would cost."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* world)
+	{
+		if (!world) return;
+
+		int32 itemCount = 0;
+		for (TActorIterator<AItem> it(world); it; ++it)
+		{
+			++itemCount;
+		}
+
+		for (TActorIterator<AShooterCharacter> it(world); it; ++it)
+		{
+			const UWidgetComponent* pickupWidget = it->GetPickupWidget();
+			if (!pickupWidget) continue;
+
+			// Every item component used to create its own user widget as well
+			SIZE_T widgetBytes = pickupWidget->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+			if (pickupWidget->GetWidget()) widgetBytes += pickupWidget->GetWidget()->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+
+			UE_LOG(LogTemp, Log, TEXT("Pickup widget %s: %.1f KB shared, about %.2f MB saved over one widget component for each of %d items"),
+				*it->GetName(), widgetBytes / 1024.f, widgetBytes * FMath::Max(itemCount - 1, 0) / (1024.f * 1024.f), itemCount);
+		}
+	}));
+
+void UPickupWidget::SetItem(AItem* _item, bool _bIsInventoryFull)
+{
+	if (item == _item && bIsInventoryFull == _bIsInventoryFull) return;
+
+	item = _item;
+	bIsInventoryFull = _bIsInventoryFull;
+
+	if (!item) return;
+
+	itemName = item->GetItemName();
+	activeStars = item->GetActiveStars();
+	glowColor = item->GetGlowColor();
+	lightColor = item->GetLightColor();
+	darkColor = item->GetDarkColor();
+	itemIcon = item->GetItemIcon();
+	ammoIcon = item->GetAmmoIcon();
+	itemAmount = item->GetItemAmount();
+
+	if (const AWeapon* weapon = Cast<AWeapon>(item))
+	{
+		itemAmount = weapon->GetAmmo();
+	}
+
+	else if (const AAmmo* ammo = Cast<AAmmo>(item))
+	{
+		ammoIcon = ammo->GetAmmoIconTexture();
+	}
+
+	OnItemSet();
+}
@@ -0,0 +1,64 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "PickupWidget.generated.h"
+
+class AItem;
+class UTexture2D;
+
+/*
+Base for the pickup popups. The character keeps one per item type and points it at whichever item is under
+the crosshair, so the widget reads everything it shows from here rather than from its own item.
+*/
+UCLASS(Abstract)
+class ADVANCEDSHOOTER_API UPickupWidget : public UUserWidget
+{
+	GENERATED_BODY()
+
+public:
+	// Copies the items display data and calls OnItemSet, does nothing when neither the item nor the flag changed
+	void SetItem(AItem* _item, bool _bIsInventoryFull);
+
+	FORCEINLINE AItem* GetItem() const { return item; }
+
+protected:
+	// Refresh the widget from the properties below
+	UFUNCTION(BlueprintImplementableEvent, Category = "Pickup")
+	void OnItemSet();
+
+private:
+	UPROPERTY(BlueprintReadOnly, Category = "Pickup", meta = (AllowPrivateAccess = "true"))
+	AItem* item;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Pickup", meta = (AllowPrivateAccess = "true"))
+	FString itemName;
+
+	// Ammo left in a weapon, or the amount of an ammo pickup
+	UPROPERTY(BlueprintReadOnly, Category = "Pickup", meta = (AllowPrivateAccess = "true"))
+	int32 itemAmount = 0;
+
+	// Zero element isnt used, same as on the item
+	UPROPERTY(BlueprintReadOnly, Category = "Pickup", meta = (AllowPrivateAccess = "true"))
+	TArray<bool> activeStars;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Pickup|Rarity", meta = (AllowPrivateAccess = "true"))
+	FLinearColor glowColor;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Pickup|Rarity", meta = (AllowPrivateAccess = "true"))
+	FLinearColor lightColor;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Pickup|Rarity", meta = (AllowPrivateAccess = "true"))
+	FLinearColor darkColor;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Pickup", meta = (AllowPrivateAccess = "true"))
+	UTexture2D* itemIcon;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Pickup", meta = (AllowPrivateAccess = "true"))
+	UTexture2D* ammoIcon;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Pickup", meta = (AllowPrivateAccess = "true"))
+	bool bIsInventoryFull = false;
+};
@@ -0,0 +1,130 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/*
+Uniform grid that buckets elements by the cell their location falls in, so finding everything near a point
+only looks at the few cells the query sphere touches instead of every element.
+Elements must be hashable and are expected to be added once and moved rarely.
+*/
+template<typename ElementType>
+class TSpatialHashGrid
+{
+public:
+	explicit TSpatialHashGrid(float inCellSize = 500.f)
+	{
+		SetCellSize(inCellSize);
+	}
+
+	// Only takes effect while the grid is empty, existing elements would be in the wrong cells
+	void SetCellSize(float inCellSize)
+	{
+		if (entries.Num() > 0) return;
+		cellSize = FMath::Max(inCellSize, 1.f);
+	}
+
+	void Add(const ElementType& element, const FVector& location)
+	{
+		Remove(element);
+
+		const FIntVector cell = GetCell(location);
+		cells.FindOrAdd(cell).Add(element);
+		entries.Add(element, FEntry{ cell, location });
+	}
+
+	void Remove(const ElementType& element)
+	{
+		const FEntry* entry = entries.Find(element);
+		if (!entry) return;
+
+		RemoveFromCell(element, entry->cell);
+		entries.Remove(element);
+	}
+
+	// Cheap when the element stays in the same cell
+	void Move(const ElementType& element, const FVector& location)
+	{
+		FEntry* entry = entries.Find(element);
+		if (!entry) return;
+
+		const FIntVector cell = GetCell(location);
+		entry->location = location;
+
+		if (cell == entry->cell) return;
+
+		RemoveFromCell(element, entry->cell);
+		cells.FindOrAdd(cell).Add(element);
+		entry->cell = cell;
+	}
+
+	bool Contains(const ElementType& element) const { return entries.Contains(element); }
+
+	// Appends every element within radius of center
+	template<typename AllocatorType>
+	void QuerySphere(const FVector& center, float radius, TArray<ElementType, AllocatorType>& outElements) const
+	{
+		const FIntVector minCell = GetCell(center - FVector(radius));
+		const FIntVector maxCell = GetCell(center + FVector(radius));
+		const float radiusSquared = radius * radius;
+
+		for (int32 x = minCell.X; x <= maxCell.X; ++x)
+		{
+			for (int32 y = minCell.Y; y <= maxCell.Y; ++y)
+			{
+				for (int32 z = minCell.Z; z <= maxCell.Z; ++z)
+				{
+					const TArray<ElementType>* cellElements = cells.Find(FIntVector(x, y, z));
+					if (!cellElements) continue;
+
+					for (const ElementType& element : *cellElements)
+					{
+						if (FVector::DistSquared(entries.FindChecked(element).location, center) > radiusSquared) continue;
+						outElements.Add(element);
+					}
+				}
+			}
+		}
+	}
+
+	void Reset()
+	{
+		cells.Reset();
+		entries.Reset();
+	}
+
+	int32 Num() const { return entries.Num(); }
+	int32 NumCells() const { return cells.Num(); }
+
+private:
+	struct FEntry
+	{
+		FIntVector cell;
+		FVector location;
+	};
+
+	FIntVector GetCell(const FVector& location) const
+	{
+		return FIntVector(
+			FMath::FloorToInt(location.X / cellSize),
+			FMath::FloorToInt(location.Y / cellSize),
+			FMath::FloorToInt(location.Z / cellSize));
+	}
+
+	void RemoveFromCell(const ElementType& element, const FIntVector& cell)
+	{
+		TArray<ElementType>* cellElements = cells.Find(cell);
+		if (!cellElements) return;
+
+		cellElements->RemoveSingleSwap(element, false);
+
+		// Empty cells are dropped so the map only holds occupied ones
+		if (cellElements->Num() == 0) cells.Remove(cell);
+	}
+
+	float cellSize = 500.f;
+
+	TMap<FIntVector, TArray<ElementType>> cells;
+	TMap<ElementType, FEntry> entries;
+};
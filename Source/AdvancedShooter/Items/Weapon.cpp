@@ -2,6 +2,9 @@
 
 
 #include "Weapon.h"
+#include <AdvancedShooter/Data/DataTableRegistry.h>
+#include <AdvancedShooter/Data/AssetStreamingSubsystem.h>
+#include <AdvancedShooter/Combat/PenetrationHitBuffer.h>
 
 AWeapon::AWeapon()
 {
@@ -12,6 +15,8 @@ void AWeapon::BeginPlay()
 {
 	Super::BeginPlay();
 
+	pelletStream.Initialize(pelletSeed);
+
 	if (boneToHide == FName("")) return;
 	GetItemMesh()->HideBoneByName(boneToHide, EPhysBodyOp::PBO_None);
 }
@@ -36,41 +41,30 @@ void AWeapon::OnConstruction(const FTransform& transform)
 	SetWeaponData();
 }
 
-UDataTable* AWeapon::GetWeaponDataTable()
+void FWeaponDataTable::GetAssetPaths(TArray<FSoftObjectPath>& outPaths) const
 {
-	// Load data in the item rarity data table
-
-	// Path to the item rarity data table
-	FString weaponTablePath = TEXT("DataTable'/Game/_Game/DataTable/DT_Weapon.DT_Weapon'");
-
-	UDataTable* weaponTableObject = Cast<UDataTable>(StaticLoadObject(UDataTable::StaticClass(), NULL, *weaponTablePath));
-
-	if (!weaponTableObject) return NULL;
-
-	return weaponTableObject;
+	AddAssetPath(shootSound, outPaths);
+	AddAssetPath(pickupSound, outPaths);
+	AddAssetPath(equipSound, outPaths);
+	AddAssetPath(itemMesh, outPaths);
+	AddAssetPath(inventoryIcon, outPaths);
+	AddAssetPath(ammoIcon, outPaths);
+	AddAssetPath(crosshairsMiddle, outPaths);
+	AddAssetPath(crosshairsLeft, outPaths);
+	AddAssetPath(crosshairsRight, outPaths);
+	AddAssetPath(crosshairsBottom, outPaths);
+	AddAssetPath(crosshairsTop, outPaths);
+	AddAssetPath(materialInstance, outPaths);
+	AddAssetPath(animBP, outPaths);
+	AddAssetPath(muzzleFlash, outPaths);
 }
 
 void AWeapon::SetWeaponData()
 {
-	FWeaponDataTable* weaponDataRow = NULL;
-
-	switch (weaponType)
-	{
-		case EWeaponType::EWT_SubmachineGun:
-			weaponDataRow =  GetWeaponDataTable()->FindRow<FWeaponDataTable>(FName("SMG"), TEXT(""));
-			break;
-
-		case EWeaponType::EWT_AssaultRifle:
-			weaponDataRow = GetWeaponDataTable()->FindRow<FWeaponDataTable>(FName("AR"), TEXT(""));
-			break;
-
-		case EWeaponType::EWT_Pistol:
-			weaponDataRow = GetWeaponDataTable()->FindRow<FWeaponDataTable>(FName("Pistol"), TEXT(""));
-			break;
-		default:
-			break;
-	}
+	UDataTableRegistry* registry = UDataTableRegistry::Get();
+	if (!registry) return;
 
+	const FWeaponDataTable* weaponDataRow = registry->GetWeaponRow(weaponType);
 	if (!weaponDataRow) return;
 
 	ammoType = weaponDataRow->ammoType;
@@ -78,40 +72,79 @@ void AWeapon::SetWeaponData()
 	magazineCap = weaponDataRow->magazineCap;
 	weaponRecoil = weaponDataRow->recoil;
 
-	SetPickupSound(weaponDataRow->pickupSound);
-	SetEquipSound(weaponDataRow->equipSound);
 	SetItemName(weaponDataRow->itemName);
-	GetItemMesh()->SetSkeletalMesh(weaponDataRow->itemMesh);
-	SetItemIcon(weaponDataRow->inventoryIcon);
-	SetAmmoIcon(weaponDataRow->ammoIcon);
 	SetClipBoneName(weaponDataRow->clipBoneName);
 	SetReloadMontageSection(weaponDataRow->reloadMontageSection);
-	SetMaterialInstance(weaponDataRow->materialInstance);
-	GetItemMesh()->SetAnimInstanceClass(weaponDataRow->animBP);
-
-	previousMatIndex = GetMaterialIndex();
-	GetItemMesh()->SetMaterial(previousMatIndex, NULL);
-	SetMaterialIndex(weaponDataRow->materialIndex);
-	
-	crosshairsMiddle = weaponDataRow->crosshairsMiddle;
-	crosshairsLeft = weaponDataRow->crosshairsLeft;
-	crosshairsRight = weaponDataRow->crosshairsRight;
-	crosshairsBottom = weaponDataRow->crosshairsBottom;
-	crosshairsTop = weaponDataRow->crosshairsTop;
-
 
 	fireRate = weaponDataRow->fireRate;
-	shootSound = weaponDataRow->shootSound;
-	muzzleFlash = weaponDataRow->muzzleFlash;
 
 	boneToHide = weaponDataRow->boneToHide;
 	bIsAutomatic = weaponDataRow->bIsAutomatic;
 	damage = weaponDataRow->damage;
 	headShotDamage = weaponDataRow->headShotDamage;
 
+	maxPenetrationHits = FMath::Clamp(weaponDataRow->maxPenetrationHits, 1, MAX_PENETRATION_HITS);
+	penetrationDepth = weaponDataRow->penetrationDepth;
+	penetrationDamageFalloff = FMath::Clamp(weaponDataRow->penetrationDamageFalloff, 0.f, 1.f);
+
+	pelletCount = FMath::Clamp(weaponDataRow->pelletCount, 1, MAX_PELLETS);
+	pelletSpread = weaponDataRow->pelletSpread;
+
+	projectileSpeed = weaponDataRow->projectileSpeed;
+	projectileGravityScale = weaponDataRow->projectileGravityScale;
+	projectileDrag = weaponDataRow->projectileDrag;
+	projectileLifetime = weaponDataRow->projectileLifetime;
+	projectileRadius = weaponDataRow->projectileRadius;
+
 	// Scale damage based of rarity
 	CalculateDamage();
 
+	// Meshes, sounds and textures stream in, the rest of the weapon works without them
+	TArray<FSoftObjectPath> assetPaths;
+	weaponDataRow->GetAssetPaths(assetPaths);
+
+	const bool bAssetsReady = UAssetStreamingSubsystem::RequestAssets(this, EGameDataTable::EGDT_Weapon, (uint8)weaponType, assetPaths,
+		FSimpleDelegate::CreateUObject(this, &AWeapon::SetWeaponAssets));
+
+	if (bAssetsReady) return;
+	ShowPlaceholderMesh();
+}
+
+void AWeapon::SetWeaponAssets()
+{
+	UDataTableRegistry* registry = UDataTableRegistry::Get();
+	if (!registry) return;
+
+	const FWeaponDataTable* weaponDataRow = registry->GetWeaponRow(weaponType);
+	if (!weaponDataRow) return;
+
+	SetPickupSound(weaponDataRow->pickupSound.Get());
+	SetEquipSound(weaponDataRow->equipSound.Get());
+	GetItemMesh()->SetSkeletalMesh(weaponDataRow->itemMesh.Get());
+	SetItemIcon(weaponDataRow->inventoryIcon.Get());
+	SetAmmoIcon(weaponDataRow->ammoIcon.Get());
+	SetMaterialInstance(weaponDataRow->materialInstance.Get());
+	GetItemMesh()->SetAnimInstanceClass(weaponDataRow->animBP.Get());
+
+	previousMatIndex = GetMaterialIndex();
+	GetItemMesh()->SetMaterial(previousMatIndex, NULL);
+	SetMaterialIndex(weaponDataRow->materialIndex);
+	
+	crosshairsMiddle = weaponDataRow->crosshairsMiddle.Get();
+	crosshairsLeft = weaponDataRow->crosshairsLeft.Get();
+	crosshairsRight = weaponDataRow->crosshairsRight.Get();
+	crosshairsBottom = weaponDataRow->crosshairsBottom.Get();
+	crosshairsTop = weaponDataRow->crosshairsTop.Get();
+
+	shootSound = weaponDataRow->shootSound.Get();
+	muzzleFlash = weaponDataRow->muzzleFlash.Get();
+
+	// BeginPlay already hid the bone on the placeholder
+	if (HasActorBegunPlay() && boneToHide != FName(""))
+	{
+		GetItemMesh()->HideBoneByName(boneToHide, EPhysBodyOp::PBO_None);
+	}
+
 	if (!GetMaterialInstance()) return;
 
 	// Create a new material instance
@@ -122,15 +155,111 @@ void AWeapon::SetWeaponData()
 	EnableGlowMaterial();
 }
 
+bool AWeapon::HotApplyWeaponData()
+{
+	UDataTableRegistry* registry = UDataTableRegistry::Get();
+	if (!registry) return false;
+
+	const FWeaponDataTable* oldRow = registry->GetPreviousWeaponRow(weaponType);
+	const FWeaponDataTable* newRow = registry->GetWeaponRow(weaponType);
+	if (!oldRow || !newRow) return false;
+
+	bool bChanged = false;
+
+	// Only fields that were edited, anything gameplay changed on this weapon since construction is left alone
+	if (newRow->fireRate != oldRow->fireRate)
+	{
+		fireRate = newRow->fireRate;
+		bChanged = true;
+	}
+
+	if (newRow->recoil != oldRow->recoil)
+	{
+		weaponRecoil = newRow->recoil;
+		bChanged = true;
+	}
+
+	if (newRow->damage != oldRow->damage)
+	{
+		damage = newRow->damage * GetDamageScalar();
+		bChanged = true;
+	}
+
+	if (newRow->headShotDamage != oldRow->headShotDamage)
+	{
+		headShotDamage = newRow->headShotDamage * GetHeadshotDamageScalar();
+		bChanged = true;
+	}
+
+	return bChanged;
+}
+
+uint8 AWeapon::GetPoolRow() const
+{
+	return static_cast<uint8>(weaponType);
+}
+
+void AWeapon::SetPoolRow(uint8 row)
+{
+	weaponType = static_cast<EWeaponType>(row);
+}
+
+void AWeapon::ResetFromPool(const FTransform& transform, EItemRarity rarity)
+{
+	Super::ResetFromPool(transform, rarity);
+
+	bIsFalling = false;
+	bIsMovingClip = false;
+	FinishMovingSlide();
+
+	UDataTableRegistry* registry = UDataTableRegistry::Get();
+	if (!registry) return;
+
+	const FWeaponDataTable* weaponDataRow = registry->GetWeaponRow(weaponType);
+	if (!weaponDataRow) return;
+
+	ammo = weaponDataRow->weaponAmmo;
+
+	// Rarity may have changed, so scale from the rows damage again
+	damage = weaponDataRow->damage;
+	headShotDamage = weaponDataRow->headShotDamage;
+	CalculateDamage();
+}
+
+void AWeapon::ReturnToPool()
+{
+	Super::ReturnToPool();
+
+	bIsFalling = false;
+	FinishMovingSlide();
+}
+
+bool AWeapon::WantsTick() const
+{
+	return Super::WantsTick() || bIsFalling || bMovingSlide;
+}
+
 void AWeapon::FinishMovingSlide()
 {
 	bMovingSlide = false;
+
+	// No more ticks to settle the slide, so put it where the curve starts
+	if (slideDisplacementCurve)
+	{
+		const float curveValue = slideDisplacementCurve->GetFloatValue(0.f);
+		slideDisplacement = curveValue * maxSlideDisplacement;
+		recoilRotation = curveValue * maxRecoilRotation;
+	}
+
+	RefreshTickEnabled();
 }
 
 void AWeapon::StartSlideTimer()
 {
 	bMovingSlide = true;
 	GetWorldTimerManager().SetTimer(slideTimer, this, &AWeapon::FinishMovingSlide, slideDisplacementTime);
+
+	RefreshTickEnabled();
 }
 
 void AWeapon::UpdateSlideDisplacement()
@@ -168,6 +297,7 @@ void AWeapon::ThrowWeapon()
 	GetItemMesh()->AddImpulse(impulseDirection);
 
 	bIsFalling = true;
+	RefreshTickEnabled();
 
 	GetWorldTimerManager().SetTimer(throwWeaponTimer, this, &AWeapon::StopFalling, throwWeaponTime);
 
@@ -181,6 +311,18 @@ void AWeapon::ReloadAmmo(int32 amount)
 	ammo += amount;
 }
 
+void AWeapon::GeneratePelletDirections(const FVector& aimDirection, FPelletDirections& outDirections)
+{
+	outDirections.Reset();
+
+	const float halfAngle = FMath::DegreesToRadians(pelletSpread);
+
+	for (int32 i = 0; i < pelletCount; ++i)
+	{
+		outDirections.Add(pelletStream.VRandCone(aimDirection, halfAngle));
+	}
+}
+
 void AWeapon::DecrementAmmo()
 {
 	if (ammo - 1 <= 0)
@@ -194,5 +336,6 @@ void AWeapon::StopFalling()
 {
 	bIsFalling = false;
 	SetItemState(EItemState::EIS_Pickup);
-	ResetPulseTimer();
+
+	RefreshTickEnabled();
 }
@@ -15,6 +15,7 @@ enum class EWeaponType : uint8
 	EWT_SubmachineGun UMETA(DisplayName = "SubmachineGun"),
 	EWT_AssaultRifle UMETA(DisplayName = "Assault Rifle"),
 	EWT_Pistol UMETA(DisplayName = "Pistol"),
+	EWT_Shotgun UMETA(DisplayName = "Shotgun"),
 	
 	EWT_MAX UMETA(DisplayName = "Default Max"),
 };
@@ -24,10 +25,17 @@ enum class EAmmoType : uint8
 {
 	EAT_9mm UMETA(DisplayName = "9mm"),
 	EAT_AR UMETA(DisplayName = "Assault Rifle"),
+	EAT_Shells UMETA(DisplayName = "Shells"),
 
 	EAT_MAX UMETA(DisplayName = "Default Max"),
 };
 
+// Most pellets one shot can fire
+constexpr int32 MAX_PELLETS = 16;
+
+// Pellet directions for one shot, inline so generating them doesnt allocate
+typedef TArray<FVector, TInlineAllocator<MAX_PELLETS>> FPelletDirections;
+
 USTRUCT(BlueprintType)
 struct FWeaponDataTable : public FTableRowBase
 {
@@ -69,50 +77,91 @@ struct FWeaponDataTable : public FTableRowBase
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Damage")
 	float headShotDamage;
 
+	// Surfaces and enemies one bullet can hit, 1 stops at the first hit
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Damage|Penetration", meta = (ClampMin = "1", ClampMax = "8"))
+	int32 maxPenetrationHits = 1;
+
+	// Thickest surface in cm a bullet can pass through
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Damage|Penetration")
+	float penetrationDepth = 0.f;
+
+	// Fraction of damage lost for every surface or enemy the bullet passes through
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Damage|Penetration", meta = (ClampMin = "0", ClampMax = "1"))
+	float penetrationDamageFalloff = 0.5f;
+
+	// Pellets fired per shot, more than 1 makes the weapon a shotgun
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pellets", meta = (ClampMin = "1", ClampMax = "16"))
+	int32 pelletCount = 1;
+
+	// Half angle in degrees of the cone pellets spread in
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pellets")
+	float pelletSpread = 0.f;
+
+	// Launch speed of the weapons projectiles, 0 makes the weapon hitscan
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Projectile")
+	float projectileSpeed = 0.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Projectile")
+	float projectileGravityScale = 1.f;
+
+	// Fraction of speed lost per second
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Projectile")
+	float projectileDrag = 0.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Projectile")
+	float projectileLifetime = 5.f;
+
+	// Sweep radius, 0 for a line trace
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Projectile")
+	float projectileRadius = 0.f;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	int32 materialIndex;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sounds")
-	USoundBase* shootSound;
+	TSoftObjectPtr<USoundBase> shootSound;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sounds")
-	USoundBase* pickupSound;
+	TSoftObjectPtr<USoundBase> pickupSound;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sounds")
-	USoundBase* equipSound;
+	TSoftObjectPtr<USoundBase> equipSound;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	USkeletalMesh* itemMesh;
+	TSoftObjectPtr<USkeletalMesh> itemMesh;
 	
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Textures")
-	UTexture2D* inventoryIcon;
+	TSoftObjectPtr<UTexture2D> inventoryIcon;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Textures")
-	UTexture2D* ammoIcon;
+	TSoftObjectPtr<UTexture2D> ammoIcon;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Crosshair")
-	UTexture2D* crosshairsMiddle;
+	TSoftObjectPtr<UTexture2D> crosshairsMiddle;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Crosshair")
-	UTexture2D* crosshairsLeft;
+	TSoftObjectPtr<UTexture2D> crosshairsLeft;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Crosshair")
-	UTexture2D* crosshairsRight;
+	TSoftObjectPtr<UTexture2D> crosshairsRight;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Crosshair")
-	UTexture2D* crosshairsBottom;
+	TSoftObjectPtr<UTexture2D> crosshairsBottom;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Crosshair")
-	UTexture2D* crosshairsTop;
+	TSoftObjectPtr<UTexture2D> crosshairsTop;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	UMaterialInstance* materialInstance;
+	TSoftObjectPtr<UMaterialInstance> materialInstance;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	TSubclassOf<UAnimInstance> animBP;
+	TSoftClassPtr<UAnimInstance> animBP;
 	
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Particles")
-	UParticleSystem* muzzleFlash;
+	TSoftObjectPtr<UParticleSystem> muzzleFlash;
+
+	// Soft references for the streaming subsystem to load together
+	void GetAssetPaths(TArray<FSoftObjectPath>& outPaths) const;
 };
 
 UCLASS()
@@ -153,6 +202,23 @@ public:
 	FORCEINLINE float GetDamage() { return damage; }
 	FORCEINLINE float GetHeadShotDamage() { return headShotDamage; }
 
+	FORCEINLINE int32 GetMaxPenetrationHits() const { return maxPenetrationHits; }
+	FORCEINLINE float GetPenetrationDepth() const { return penetrationDepth; }
+	FORCEINLINE float GetPenetrationDamageFalloff() const { return penetrationDamageFalloff; }
+
+	FORCEINLINE int32 GetPelletCount() const { return pelletCount; }
+
+	// Spreads pelletCount directions around aimDirection in one pass using the weapons seeded stream
+	void GeneratePelletDirections(const FVector& aimDirection, FPelletDirections& outDirections);
+
+	// Projectile weapons launch rounds through the projectile subsystem instead of tracing
+	FORCEINLINE bool FiresProjectiles() const { return projectileSpeed > 0.f; }
+	FORCEINLINE float GetProjectileSpeed() const { return projectileSpeed; }
+	FORCEINLINE float GetProjectileGravityScale() const { return projectileGravityScale; }
+	FORCEINLINE float GetProjectileDrag() const { return projectileDrag; }
+	FORCEINLINE float GetProjectileLifetime() const { return projectileLifetime; }
+	FORCEINLINE float GetProjectileRadius() const { return projectileRadius; }
+
 	FORCEINLINE void SetIsMovingClip(bool move) { bIsMovingClip = move; }
 
 	void SetClipBoneName(FName bone) { clipBoneName = bone; }
@@ -164,13 +230,27 @@ public:
 
 	void StartSlideTimer();
 
+	// Copies tuning fields that changed in the weapon table into this weapon, true if any did
+	bool HotApplyWeaponData();
+
+	// Pooled per weapon type, a reset weapon gets a full magazine and the damage of its new rarity
+	virtual uint8 GetPoolRow() const override;
+	virtual void SetPoolRow(uint8 row) override;
+	virtual void ResetFromPool(const FTransform& transform, EItemRarity rarity) override;
+	virtual void ReturnToPool() override;
+
 protected:
 	void StopFalling();
 
 	virtual void OnConstruction(const FTransform& transform) override;
 	virtual void BeginPlay() override;
-	UDataTable* GetWeaponDataTable();
 	void SetWeaponData();
+
+	// Also ticks while falling or moving the slide
+	virtual bool WantsTick() const override;
+
+	// Applies the rows streamed meshes, sounds and textures
+	void SetWeaponAssets();
 	void FinishMovingSlide();
 
 	void UpdateSlideDisplacement();
@@ -283,5 +363,50 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Properties|Damage", meta = (AllowPrivateAccess = "true"))
 	float headShotDamage;
 
+	// Surfaces and enemies one bullet can hit
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Properties|Damage", meta = (AllowPrivateAccess = "true"))
+	int32 maxPenetrationHits = 1;
+
+	// Thickest surface a bullet can pass through
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Properties|Damage", meta = (AllowPrivateAccess = "true"))
+	float penetrationDepth = 0.f;
+
+	// Damage lost per penetrated surface
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Properties|Damage", meta = (AllowPrivateAccess = "true"))
+	float penetrationDamageFalloff = 0.5f;
+
+	// PELLETS
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Properties|Pellets", meta = (AllowPrivateAccess = "true"))
+	int32 pelletCount = 1;
+
+	// Half angle of the pellet cone in degrees
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Properties|Pellets", meta = (AllowPrivateAccess = "true"))
+	float pelletSpread = 0.f;
+
+	// Seed for the pellet spread, the same seed gives the same pattern every run
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Properties|Pellets", meta = (AllowPrivateAccess = "true"))
+	int32 pelletSeed = 0;
+
+	FRandomStream pelletStream;
+
+	// PROJECTILE
+
+	// Launch speed, 0 when the weapon is hitscan
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Properties|Projectile", meta = (AllowPrivateAccess = "true"))
+	float projectileSpeed = 0.f;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Properties|Projectile", meta = (AllowPrivateAccess = "true"))
+	float projectileGravityScale = 1.f;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Properties|Projectile", meta = (AllowPrivateAccess = "true"))
+	float projectileDrag = 0.f;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Properties|Projectile", meta = (AllowPrivateAccess = "true"))
+	float projectileLifetime = 5.f;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Properties|Projectile", meta = (AllowPrivateAccess = "true"))
+	float projectileRadius = 0.f;
+
 
 };
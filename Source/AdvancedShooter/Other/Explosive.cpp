@@ -4,6 +4,8 @@
 #include <Particles/ParticleSystemComponent.h>
 #include <Components/SphereComponent.h>
 #include <GameFramework/Character.h>
+#include <AdvancedShooter/Effects/ParticlePoolSubsystem.h>
+#include <AdvancedShooter/Combat/DamagePipelineSubsystem.h>
 // Sets default values
 AExplosive::AExplosive()
 {
@@ -37,14 +39,20 @@ void AExplosive::BulletHit_Implementation(FHitResult hitResult, AActor* shooter,
 	
 	UGameplayStatics::PlaySoundAtLocation(this, impactSound, GetActorLocation());
 	
-	UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), explodeParticles, hitResult.ImpactPoint, FRotator::ZeroRotator, true);
+	UParticlePoolSubsystem::SpawnPooledEmitter(this, explodeParticles, hitResult.ImpactPoint);
 
 	TArray<AActor*> overlappingActors;
 	GetOverlappingActors(overlappingActors, ACharacter::StaticClass());
 
 	for (AActor* actor : overlappingActors)
 	{
-		UGameplayStatics::ApplyDamage(actor, explosiveDamage, instigator, shooter, UDamageType::StaticClass());
+		FQueuedDamage damage;
+		damage.target = actor;
+		damage.instigator = instigator;
+		damage.causer = shooter;
+		damage.amount = explosiveDamage;
+
+		UDamagePipelineSubsystem::QueueDamage(this, damage);
 	}
 	Destroy();
 }
@@ -16,7 +16,13 @@
 #include <AdvancedShooter/BulletHitInterface.h>
 #include <AdvancedShooter/AI/Enemy.h>
 #include <AdvancedShooter/AI/EnemyController.h>
-#include <BehaviorTree/BlackboardComponent.h>
+#include <AdvancedShooter/Combat/HitscanSubsystem.h>
+#include <AdvancedShooter/Combat/DamagePipelineSubsystem.h>
+#include <AdvancedShooter/Combat/ProjectileSubsystem.h>
+#include <AdvancedShooter/Effects/ParticlePoolSubsystem.h>
+#include <AdvancedShooter/Items/PickupRegistrySubsystem.h>
+#include <AdvancedShooter/Items/ItemPoolSubsystem.h>
+#include <AdvancedShooter/Items/PickupWidget.h>
 
 // Sets default values
 AShooterCharacter::AShooterCharacter()
@@ -49,6 +55,14 @@ AShooterCharacter::AShooterCharacter()
 
 	health = maxHealth;
 
+	// Shared pickup popup, drawn in screen space so there is no render target
+	pickupWidget = CreateDefaultSubobject<UWidgetComponent>(TEXT("Pickup Widget"));
+	pickupWidget->SetupAttachment(GetRootComponent());
+	pickupWidget->SetWidgetSpace(EWidgetSpace::Screen);
+	pickupWidget->SetDrawAtDesiredSize(true);
+	pickupWidget->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	pickupWidget->SetVisibility(false);
+
 	// Create hand scene comp
 	handSceneComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Hand Scene Component"));
 
@@ -96,6 +110,10 @@ void AShooterCharacter::BeginPlay()
 	InitAmmoMap();
 	InitInterpLocations();
 	GetCharacterMovement()->MaxWalkSpeed = baseMoveSpeed;
+
+	fireScheduler.SetMaxShotsPerTick(maxShotsPerTick);
+
+	PrewarmParticlePools();
 }
 
 // Called every frame
@@ -107,9 +125,13 @@ void AShooterCharacter::Tick(float DeltaTime)
 
 	CalculateCrosshairsSpread(DeltaTime);
 
+	UpdateFireScheduler();
+
 	if (combatState == ECombatState::ECS_ShootTimerInProgress)
 		ApplyRecoil();
 
+	QueryNearbyPickups();
+
 	TraceForItems();
 
 	// Interpolate capsule half height based on crouching/standing
@@ -265,29 +287,73 @@ void AShooterCharacter::ShootWeapon()
 {
 	if (!equippedWeapon) return;
 	if (combatState != ECombatState::ECS_Unoccupied) return;
-	
-	if (WeaponHasAmmo())
-	{
-		PlayShootSound();
+	if (!WeaponHasAmmo()) return;
 
-		SendBullet();
+	// First shot goes out on the press, the scheduler times the rest of the cycle from here
+	FScheduledShot firstShot;
+	firstShot.fireTime = GetWorld()->GetTimeSeconds();
+	firstShot.muzzleTransform = GetMuzzleTransform();
 
-		//ApplyRecoil(GetWorld()->GetDeltaSeconds());
-		
-		PlayGunFireMontage();
+	FireShots(MakeArrayView(&firstShot, 1));
+
+	fireScheduler.Start(equippedWeapon, firstShot.fireTime, firstShot.muzzleTransform);
+	combatState = ECombatState::ECS_ShootTimerInProgress;
+}
 
-		// Subtract 1 from weapon ammo
+void AShooterCharacter::FireShots(TArrayView<const FScheduledShot> shots)
+{
+	if (!equippedWeapon || shots.Num() == 0) return;
+
+	// Sound and montage play once per batch, several in one frame would just stack on top of each other
+	PlayShootSound();
+
+	SendBullets(shots);
+
+	PlayGunFireMontage();
+
+	// Subtract the rounds fired this tick from weapon ammo
+	for (int32 i = 0; i < shots.Num(); ++i)
+	{
 		equippedWeapon->DecrementAmmo();
+	}
 
-		StartCrosshairBulletFire();
-		// Starts bullet fire timer for crosshair
-		StartShootTimer();
+	StartCrosshairBulletFire();
 
-		if (equippedWeapon->GetWeaponType() == EWeaponType::EWT_Pistol)
-		{
-			equippedWeapon->StartSlideTimer();
-		}
+	if (equippedWeapon->GetWeaponType() == EWeaponType::EWT_Pistol)
+	{
+		equippedWeapon->StartSlideTimer();
+	}
+}
+
+void AShooterCharacter::UpdateFireScheduler()
+{
+	if (combatState != ECombatState::ECS_ShootTimerInProgress)
+	{
+		// Stunned or knocked out of the fire cycle some other way
+		if (fireScheduler.IsFiring()) fireScheduler.Stop();
+		return;
 	}
+
+	const bool bKeepFiring = bShootPressed && equippedWeapon && equippedWeapon->GetIsAutomatic();
+	const int32 availableShots = equippedWeapon ? equippedWeapon->GetAmmo() : 0;
+
+	scheduledShots.Reset();
+
+	const bool bStillFiring = fireScheduler.Advance(equippedWeapon, GetWorld()->GetTimeSeconds(),
+		GetMuzzleTransform(), bKeepFiring, availableShots, scheduledShots);
+
+	FireShots(scheduledShots);
+
+	if (!bStillFiring)
+		FinishFireCycle();
+}
+
+void AShooterCharacter::FinishFireCycle()
+{
+	combatState = ECombatState::ECS_Unoccupied;
+
+	if (!WeaponHasAmmo())
+		ReloadWeapon();
 }
 
 void AShooterCharacter::ApplyRecoil()
@@ -302,77 +368,213 @@ void AShooterCharacter::PlayShootSound()
 	UGameplayStatics::SpawnSoundAtLocation(GetWorld(), equippedWeapon->GetShootSound(), GetActorLocation());
 }
 
-void AShooterCharacter::SendBullet()
+FTransform AShooterCharacter::GetMuzzleTransform() const
 {
-	// Send Bullet
+	if (!equippedWeapon) return GetActorTransform();
 
 	// Get and assign barrel socket from mesh
 	const USkeletalMeshSocket* barrelSocket = equippedWeapon->GetItemMesh()->GetSocketByName("BarrelSocket");
 
-	if (!barrelSocket) return;
-	const FTransform socketTransform = barrelSocket->GetSocketTransform(equippedWeapon->GetItemMesh());
+	if (!barrelSocket) return equippedWeapon->GetItemMesh()->GetComponentTransform();
+	return barrelSocket->GetSocketTransform(equippedWeapon->GetItemMesh());
+}
 
+void AShooterCharacter::SendBullets(TArrayView<const FScheduledShot> shots)
+{
+	// Muzzle flash at the latest shot only
 	if (equippedWeapon->GetMuzzleFlash())
 	{
-		UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), equippedWeapon->GetMuzzleFlash(), socketTransform);
+		UParticlePoolSubsystem::SpawnPooledEmitter(this, equippedWeapon->GetMuzzleFlash(), shots.Last().muzzleTransform);
 	}
-	
-	FHitResult trailHitResult;
 
-	bool bTrailEnd = GetTrailEndLocation(socketTransform.GetLocation(), trailHitResult);
+	if (equippedWeapon->FiresProjectiles())
+	{
+		LaunchProjectiles(shots);
+		return;
+	}
 
-	if (!bTrailEnd) return;
+	FVector crosshairDirection;
+	FHitscanShot bullet;
 
-	
+	if (!GetCrosshairRay(bullet.crosshairStart, crosshairDirection)) return;
+
+	bullet.shooter = this;
+	bullet.crosshairEnd = bullet.crosshairStart + crosshairDirection * bulletTraceRange;
+	bullet.damage = equippedWeapon->GetDamage();
+	bullet.headShotDamage = equippedWeapon->GetHeadShotDamage();
+	bullet.maxHits = equippedWeapon->GetMaxPenetrationHits();
+	bullet.penetrationDepth = equippedWeapon->GetPenetrationDepth();
+	bullet.penetrationFalloff = equippedWeapon->GetPenetrationDamageFalloff();
+
+	const int32 pelletCount = equippedWeapon->GetPelletCount();
+
+	// Every bullet and pellet this tick shares the crosshair ray, so trace it once here when there is more than one
+	if (!UHitscanSubsystem::IsAsyncEnabled() || crosshairQuery.HasTrace(this, bulletTraceRange) || shots.Num() > 1 || pelletCount > 1)
+	{
+		FHitResult crosshairHitResult;
+		TraceUnderCrosshair(crosshairHitResult, bullet.aimLocation, bulletTraceRange);
+		bullet.bCrosshairResolved = true;
+	}
+
+	TArray<FHitscanShot, TInlineAllocator<MAX_PELLETS>> bullets;
+	FPelletDirections pelletDirections;
+
+	for (const FScheduledShot& shot : shots)
+	{
+		if (pelletCount <= 1)
+		{
+			FHitscanShot& queuedBullet = bullets.Add_GetRef(bullet);
+			queuedBullet.muzzleTransform = shot.muzzleTransform;
+			queuedBullet.fireTime = shot.fireTime;
+			continue;
+		}
+
+		// Pellets spread around the crosshair aim and go out with the rest of this frames traces
+		const FVector muzzleLocation = shot.muzzleTransform.GetLocation();
+		const FVector muzzleToAim = bullet.aimLocation - muzzleLocation;
+		const float aimDistance = muzzleToAim.Size();
+
+		equippedWeapon->GeneratePelletDirections(muzzleToAim.GetSafeNormal(), pelletDirections);
+
+		for (const FVector& pelletDirection : pelletDirections)
+		{
+			FHitscanShot& pellet = bullets.Add_GetRef(bullet);
+			pellet.muzzleTransform = shot.muzzleTransform;
+			pellet.fireTime = shot.fireTime;
+			pellet.aimLocation = muzzleLocation + pelletDirection * aimDistance;
+		}
+	}
+
+	// Traced now or batched with the rest of this frames shots depending on Shooter.Hitscan.Async
+	UHitscanSubsystem* hitscanSubsystem = GetWorld()->GetSubsystem<UHitscanSubsystem>();
+
+	if (!hitscanSubsystem) return;
+	hitscanSubsystem->QueueShots(bullets);
+}
+
+void AShooterCharacter::LaunchProjectiles(TArrayView<const FScheduledShot> shots)
+{
+	UProjectileSubsystem* projectileSubsystem = GetWorld()->GetSubsystem<UProjectileSubsystem>();
+	if (!projectileSubsystem) return;
+
+	// Every round this tick aims at the same crosshair point
+	FHitResult crosshairHitResult;
+	FVector aimLocation;
+	TraceUnderCrosshair(crosshairHitResult, aimLocation, bulletTraceRange);
+
+	FProjectileSpawnParams projectile;
+	projectile.gravityScale = equippedWeapon->GetProjectileGravityScale();
+	projectile.drag = equippedWeapon->GetProjectileDrag();
+	projectile.lifetime = equippedWeapon->GetProjectileLifetime();
+	projectile.radius = equippedWeapon->GetProjectileRadius();
+	projectile.damage = equippedWeapon->GetDamage();
+	projectile.headShotDamage = equippedWeapon->GetHeadShotDamage();
+	projectile.owner = this;
+	projectile.instigator = GetController();
+	projectile.impactParticles = impactParticle;
+
+	const float worldTime = GetWorld()->GetTimeSeconds();
+
+	for (const FScheduledShot& shot : shots)
+	{
+		const FVector muzzleLocation = shot.muzzleTransform.GetLocation();
+
+		projectile.location = muzzleLocation;
+		projectile.velocity = (aimLocation - muzzleLocation).GetSafeNormal() * equippedWeapon->GetProjectileSpeed();
+
+		// Rounds fired earlier in the frame have already been flying for part of it
+		projectile.timeInFlight = FMath::Max(worldTime - shot.fireTime, 0.f);
 
-	if (trailHitResult.Actor.IsValid())
+		projectileSubsystem->SpawnProjectile(projectile);
+	}
+}
+
+void AShooterCharacter::ResolveBullet(const FHitscanShot& shot, TArrayView<const FHitResult> penetrationHits)
+{
+	// Barrel trace didnt hit anything
+	if (!shot.bBlockingHit) return;
+
+	if (penetrationHits.Num() > 0)
+	{
+		// The hitscan subsystem followed the bullet through whatever it could penetrate, each enemy or surface
+		// it passed through takes the same share of the damage away from everything behind it
+		const float damageKept = 1.f - FMath::Clamp(shot.penetrationFalloff, 0.f, 1.f);
+
+		float damageScale = 1.f;
+		for (const FHitResult& hitResult : penetrationHits)
+		{
+			ResolveBulletHit(shot, hitResult, damageScale);
+			damageScale *= damageKept;
+		}
+	}
+
+	else
+	{
+		ResolveBulletHit(shot, shot.hitResult, 1.f);
+	}
+
+	if (!trailParticles) return;
+	UParticleSystemComponent* trail = UParticlePoolSubsystem::SpawnPooledEmitter(this, trailParticles, shot.muzzleTransform);
+
+	if (!trail) return;
+	trail->SetVectorParameter(FName("Target"), shot.trailEnd);
+}
+
+void AShooterCharacter::ResolveBulletHit(const FHitscanShot& shot, const FHitResult& trailHitResult, float damageScale)
+{
+	AActor* hitActor = trailHitResult.GetActor();
+
+	if (hitActor)
 	{
 		// cast will only succed if hits an actor which implements bullet hit interface
-		IBulletHitInterface* bulletHitInterface = Cast<IBulletHitInterface>(trailHitResult.Actor.Get());
+		IBulletHitInterface* bulletHitInterface = Cast<IBulletHitInterface>(hitActor);
 
 		if (bulletHitInterface)
 		{
 			bulletHitInterface->BulletHit_Implementation(trailHitResult, this, GetController());
 
-			AEnemy* hitEnemy = Cast<AEnemy>(trailHitResult.Actor.Get());
-
-			float weaponDamage;
-			bool bIsHeadShot;
-			
+			AEnemy* hitEnemy = Cast<AEnemy>(hitActor);
 
 			if (hitEnemy)
 			{
-				if (trailHitResult.BoneName.ToString() == hitEnemy->GetHeadBoneName())
-				{
-					weaponDamage = equippedWeapon->GetHeadShotDamage();
-					bIsHeadShot = true;
-					UGameplayStatics::ApplyDamage(hitEnemy, weaponDamage, GetController(), this, UDamageType::StaticClass());
-				}
-
-				else
-				{
-					weaponDamage = equippedWeapon->GetDamage();
-					bIsHeadShot = false;
-					UGameplayStatics::ApplyDamage(hitEnemy, weaponDamage, GetController(), this, UDamageType::StaticClass());
-				}	
-				hitEnemy->ShowDamageNumber(weaponDamage, trailHitResult.ImpactPoint, bIsHeadShot);
+				const EHitZone hitZone = hitEnemy->GetHitZone(trailHitResult);
+				const bool bIsHeadShot = hitZone == EHitZone::Head;
+				const float weaponDamage = (bIsHeadShot ? shot.headShotDamage : shot.damage) * hitEnemy->GetHitZoneDamageMultiplier(hitZone) * damageScale;
+
+				// Applied with the rest of this frames hits on the same enemy
+				FQueuedDamage damage;
+				damage.target = hitEnemy;
+				damage.instigator = GetController();
+				damage.causer = this;
+				damage.amount = weaponDamage;
+				damage.hitLocation = trailHitResult.ImpactPoint;
+				damage.bShowDamageNumber = true;
+				damage.bIsHeadShot = bIsHeadShot;
+
+				UDamagePipelineSubsystem::QueueDamage(this, damage);
 			}
 		}
-		
-		else
+
+		else if (impactParticle)
 		{
-			// Spawn impact particles after updating trail end point
-			if (!impactParticle) return;
-			UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), impactParticle, trailHitResult.ImpactPoint);
+			// Spawn impact particles at the trail end point
+			UParticlePoolSubsystem::SpawnPooledEmitter(this, impactParticle, trailHitResult.ImpactPoint);
 		}
 	}
+}
 
+void AShooterCharacter::PrewarmParticlePools()
+{
+	UParticlePoolSubsystem* particlePool = GetWorld()->GetSubsystem<UParticlePoolSubsystem>();
+	if (!particlePool) return;
 
-	if (!trailParticles) return;
-	UParticleSystemComponent* trail = UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), trailParticles, socketTransform);
+	// Automatic fire keeps several trails and impacts alive at once
+	particlePool->PrewarmPool(trailParticles, particlePoolPrewarmCount);
+	particlePool->PrewarmPool(impactParticle, particlePoolPrewarmCount);
+	particlePool->PrewarmPool(bloodParticles, particlePoolPrewarmCount);
 
-	if (!trail) return;
-	trail->SetVectorParameter(FName("Target"), trailHitResult.ImpactPoint);
+	if (!equippedWeapon) return;
+	particlePool->PrewarmPool(equippedWeapon->GetMuzzleFlash(), particlePoolPrewarmCount);
 }
 
 void AShooterCharacter::PlayGunFireMontage()
@@ -397,14 +599,6 @@ void AShooterCharacter::ShootButtonReleased()
 	bShootPressed = false;
 }
 
-void AShooterCharacter::StartShootTimer()
-{
-	if (!equippedWeapon) return;
-	combatState = ECombatState::ECS_ShootTimerInProgress;
-
-	GetWorldTimerManager().SetTimer(autoFireTimer, this, &AShooterCharacter::AutoShootReset, equippedWeapon->GetFireRate());
-}
-
 void AShooterCharacter::StartCrosshairBulletFire()
 {
 	bShootingBullet = true;
@@ -415,59 +609,27 @@ void AShooterCharacter::FinishCrosshairBulletFire()
 {
 	bShootingBullet = false;
 }
-
-void AShooterCharacter::AutoShootReset()
-{
-	if (combatState == ECombatState::ECS_Stunned) return;
-	combatState = ECombatState::ECS_Unoccupied;
-	if (WeaponHasAmmo())
-	{
-		if (bShootPressed && equippedWeapon->GetIsAutomatic())
-		{
-			ShootWeapon();
-		}
-	}
-
-	else
-	{
-		ReloadWeapon();
-	}
-}
 ////////////////////////////////////////////////////
 
 // TRACING
 ////////////////////////////////////////////////////
-bool AShooterCharacter::TraceUnderCrosshair(FHitResult& outHitResult, FVector& outHitLocation ,float traceRange)
+bool AShooterCharacter::GetCrosshairRay(FVector& outStart, FVector& outDirection)
 {
-	// Get screen space location of crosshairs
-	FVector2D crossHairLocation = FVector2D(GetViewportSize().X / 2.f, GetViewportSize().Y / 2.f);
-	// Out params
-	FVector crossHairWorldPosition;
-	FVector crossHairWorldDirection;
-
-	// Get world position and direction of crosshairs
-	bool bScreenToWorld = UGameplayStatics::DeprojectScreenToWorld(UGameplayStatics::GetPlayerController(this, 0),
-		crossHairLocation, crossHairWorldPosition, crossHairWorldDirection);
-
-	if (bScreenToWorld)
-	{
-		const FVector start = crossHairWorldPosition;
-		const FVector end = start + crossHairWorldDirection * traceRange;
-		outHitLocation = end;
-		GetWorld()->LineTraceSingleByChannel(outHitResult, start, end, ECollisionChannel::ECC_Visibility);
-
-		if (outHitResult.bBlockingHit)
-		{
-			outHitLocation = outHitResult.Location;
-			return true;
-		}
-	}
+	return crosshairQuery.GetRay(this, outStart, outDirection);
+}
 
-	return false;
+bool AShooterCharacter::TraceUnderCrosshair(FHitResult& outHitResult, FVector& outHitLocation ,float traceRange)
+{
+	// Items and bullets share one trace per frame, clipped to the range asked for
+	return crosshairQuery.Trace(this, traceRange, outHitResult, outHitLocation);
 }
 
 void AShooterCharacter::TraceForItems()
 {
+	// Picked up or dropped while we were looking at it
+	if (pickupWidgetItem && pickupWidgetItem->GetItemState() != EItemState::EIS_Pickup)
+		HidePickupWidget();
+
 	if (bShouldTraceForItems)
 	{
 		FHitResult itemTraceResult;
@@ -499,10 +661,8 @@ void AShooterCharacter::TraceForItems()
 				traceHitItem = NULL;
 			}
 
-			if (traceHitItem->GetPickupWidget())
+			if (traceHitItem)
 			{
-				// Show Items pickup widget
-				traceHitItem->GetPickupWidget()->SetVisibility(true);
 				traceHitItem->EnableCustomDepth();
 				
 				if (inventory.Num() >= inventoryCap) // Inventory is full
@@ -512,13 +672,15 @@ void AShooterCharacter::TraceForItems()
 					traceHitItem->SetCharacterInventoryFull(false);
 			}
 
+			// Show Items pickup widget, moving it off last frames item
+			ShowPickupWidget(traceHitItem);
+
 			// We hit an item last frame
 			if (traceHitItemLastFrame)
 			{
 				if (traceHitItem != traceHitItemLastFrame)
 				{
 					// We are hiting a different item or the item is null
-					traceHitItemLastFrame->GetPickupWidget()->SetVisibility(false);
 					traceHitItemLastFrame->DisableCustomDepth();
 				}
 			}
@@ -531,11 +693,60 @@ void AShooterCharacter::TraceForItems()
 	else if (traceHitItemLastFrame)
 	{
 		// No longer overlapping
-		traceHitItemLastFrame->GetPickupWidget()->SetVisibility(false);
+		HidePickupWidget();
 		traceHitItemLastFrame->DisableCustomDepth();
 	}
 }
 
+void AShooterCharacter::ShowPickupWidget(AItem* item)
+{
+	if (!item)
+	{
+		HidePickupWidget();
+		return;
+	}
+
+	UPickupWidget** existingWidget = pickupWidgets.Find(item->GetItemType());
+	UPickupWidget* widget = existingWidget ? *existingWidget : NULL;
+
+	if (!widget)
+	{
+		const TSubclassOf<UPickupWidget>* widgetClass = pickupWidgetClasses.Find(item->GetItemType());
+		APlayerController* playerController = Cast<APlayerController>(GetController());
+		if (!widgetClass || !*widgetClass || !playerController) return;
+
+		widget = CreateWidget<UPickupWidget>(playerController, *widgetClass);
+		if (!widget) return;
+
+		pickupWidgets.Add(item->GetItemType(), widget);
+	}
+
+	if (pickupWidget->GetWidget() != widget)
+		pickupWidget->SetWidget(widget);
+
+	if (pickupWidgetItem != item)
+	{
+		pickupWidget->AttachToComponent(item->GetRootComponent(), FAttachmentTransformRules::SnapToTargetNotIncludingScale);
+		pickupWidget->SetRelativeLocation(pickupWidgetOffset);
+		pickupWidgetItem = item;
+	}
+
+	// Only refills when the item or the inventory state changed
+	widget->SetItem(item, inventory.Num() >= inventoryCap);
+
+	pickupWidget->SetVisibility(true);
+}
+
+void AShooterCharacter::HidePickupWidget()
+{
+	pickupWidget->SetVisibility(false);
+	pickupWidgetItem = NULL;
+
+	// Pooled items come back with new data under the same pointer, so forget the last one
+	if (UPickupWidget* widget = Cast<UPickupWidget>(pickupWidget->GetWidget()))
+		widget->SetItem(NULL, false);
+}
+
 void AShooterCharacter::SelectButtonPressed()
 {
 	if (combatState != ECombatState::ECS_Unoccupied) return;
@@ -550,18 +761,33 @@ void AShooterCharacter::SelectButtonReleased()
 	
 }
 
-void AShooterCharacter::IncrementOverlappedItemCount(int8 amount)
+void AShooterCharacter::IncrementOverlappedItemCount(int32 amount)
 {
-	if (overlappedItemCount + amount <= 0)
-	{
-		overlappedItemCount = 0;
-		bShouldTraceForItems = false;
-	}
+	overlappedItemCount = FMath::Max(overlappedItemCount + amount, 0);
+	bShouldTraceForItems = overlappedItemCount + nearbyPickupCount > 0;
+}
 
-	else
+void AShooterCharacter::QueryNearbyPickups()
+{
+	const UPickupRegistrySubsystem* pickupRegistry = GetWorld()->GetSubsystem<UPickupRegistrySubsystem>();
+	if (!pickupRegistry) return;
+
+	const UCapsuleComponent* capsule = GetCapsuleComponent();
+
+	autoPickups.Reset();
+	const int32 pickupCount = pickupRegistry->QueryPickups(capsule->GetComponentLocation(), capsule->GetScaledCapsuleRadius(),
+		capsule->GetScaledCapsuleHalfHeight(), autoPickups);
+
+	// Same as an area sphere end overlap
+	if (pickupCount < nearbyPickupCount) UnHighlightInventorySlot();
+
+	nearbyPickupCount = pickupCount;
+	bShouldTraceForItems = overlappedItemCount + nearbyPickupCount > 0;
+
+	// Picking up removes the item from the registry, so this runs after the query is done with it
+	for (AItem* item : autoPickups)
 	{
-		overlappedItemCount += amount;
-		bShouldTraceForItems = true;
+		item->AutoPickup(this);
 	}
 }
 ////////////////////////////////////////////////////
@@ -873,8 +1099,8 @@ AWeapon* AShooterCharacter::SpawnDefaultWeapon()
 	// Check if default weapon class is null
 	if (!defaultWeaponClass) return NULL;
 
-	// Spawn the default weapon
-	return  GetWorld()->SpawnActor<AWeapon>(defaultWeaponClass);
+	// Spawn the default weapon, from the pool when it has one spare
+	return Cast<AWeapon>(UItemPoolSubsystem::AcquirePooledItem(this, defaultWeaponClass, INDEX_NONE, FTransform::Identity));
 }
 ////////////////////////////////////////////////////
 
@@ -885,6 +1111,7 @@ void AShooterCharacter::InitAmmoMap()
 	// Adding ammo amounts to the ammo map
 	ammoMap.Add(EAmmoType::EAT_9mm, starting9mmAmmo);
 	ammoMap.Add(EAmmoType::EAT_AR, startingARAmmo);
+	ammoMap.Add(EAmmoType::EAT_Shells, startingShellsAmmo);
 }
 
 bool AShooterCharacter::WeaponHasAmmo()
@@ -928,7 +1155,8 @@ void AShooterCharacter::PickupAmmo(AAmmo* ammo)
 		}
 	}
 
-	ammo->Destroy();
+	// Back to the pool for the next ammo drop
+	UItemPoolSubsystem::ReleasePooledItem(ammo);
 }
 
 
@@ -1069,7 +1297,7 @@ float AShooterCharacter::TakeDamage(float damageAmount, FDamageEvent const& dama
 		AEnemyController* enemyController = Cast<AEnemyController>(eventInstigator);
 
 		if (!enemyController) return 0;
-		enemyController->GetBlackboardComponent()->SetValueAsBool(FName("CharacterDead"), true);
+		enemyController->SetCharacterDead(true);
 	}
 	else
 	{
@@ -1182,32 +1410,4 @@ FInterpLocation AShooterCharacter::GetInterpLocation(int32 index)
 	return FInterpLocation();
 }
 
-bool AShooterCharacter::GetTrailEndLocation(const FVector& muzzleSocketLocation, FHitResult& outHitResult)
-{
-	FVector outTrailLocation;
-	FHitResult crosshairHitResult;
-	bool bCrosshairHit = TraceUnderCrosshair(crosshairHitResult, outTrailLocation, bulletTraceRange);
-
-	if (bCrosshairHit)
-	{
-		outTrailLocation = crosshairHitResult.Location;
-	}
-
-	// Perform second trace from gun barrel
-	const FVector weaponTraceStart = muzzleSocketLocation;
-	const FVector StartToEnd = outTrailLocation - muzzleSocketLocation;
-	const FVector weaponTraceEnd = muzzleSocketLocation + StartToEnd * 1.25f;
-
-	GetWorld()->LineTraceSingleByChannel(outHitResult, weaponTraceStart, weaponTraceEnd, ECollisionChannel::ECC_Visibility);
-
-	if (!outHitResult.bBlockingHit)
-	{
-		outHitResult.Location = outTrailLocation;
-		
-		return false;
-	}
-
-	return true;
-}
-
 ////////////////////////////////////////////////////
\ No newline at end of file
@@ -5,6 +5,8 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
 #include <AdvancedShooter/Items/Weapon.h>
+#include <AdvancedShooter/Combat/CrosshairQueryCache.h>
+#include <AdvancedShooter/Combat/FireScheduler.h>
 #include "ShooterCharacter.generated.h"
 
 class USpringArmComponent;
@@ -14,6 +16,9 @@ class UParticleSystem;
 class UAnimMontage;
 class AItem;
 class AAmmo;
+class UWidgetComponent;
+class UPickupWidget;
+struct FHitscanShot;
 
 UENUM(BlueprintType)
 enum class ECombatState : uint8
@@ -63,13 +68,16 @@ public:
 
 	// Returns follow camera object
 	FORCEINLINE UCameraComponent* GetFollowCamera() const { return followCamera; }
+
+	// One popup shared by every item, attached to whichever item is under the crosshair
+	FORCEINLINE UWidgetComponent* GetPickupWidget() const { return pickupWidget; }
 	
 	// Returns whether is aiming
 	FORCEINLINE bool GetIsAiming() const { return bIsAiming; }
 
 	FORCEINLINE bool GetIsCrouching() const { return bIsCrouching; }
 
-	FORCEINLINE int8 GetNumberOfOverlappedItems() const { return overlappedItemCount; }
+	FORCEINLINE int32 GetNumberOfOverlappedItems() const { return overlappedItemCount + nearbyPickupCount; }
 
 	UFUNCTION(BlueprintCallable)
 	float GetCrosshairSpreadMultiplier() const { return crosshairSpreadMultiplier; };
@@ -79,7 +87,7 @@ public:
 	AWeapon* GetEquippedWeapon() const { return equippedWeapon; }
 
 	// Adds/subtracts to/from overlappeditemCount and updates should trace for items
-	void IncrementOverlappedItemCount(int8 amount);
+	void IncrementOverlappedItemCount(int32 amount);
 
 	void GetPickupItem(AItem* item);
 	UAnimInstance* GetAnimInstance() const { return GetMesh()->GetAnimInstance(); }
@@ -108,6 +116,9 @@ public:
 	virtual float TakeDamage(float damageAmount, struct FDamageEvent const& damageEvent, AController* eventInstigator, AActor* damageCauser) override;
 	void Stun();
 
+	// Applies damage, impact particles and the trail once a shot has been traced
+	void ResolveBullet(const FHitscanShot& shot, TArrayView<const FHitResult> penetrationHits);
+
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
@@ -130,8 +141,6 @@ protected:
 	*/
 	void LookUp(float rate);
 
-	bool GetTrailEndLocation(const FVector& muzzleSocketLocation, FHitResult& outHitResult);
-
 	void ApplyRecoil();
 
 	// Set bIsAiming to true or false
@@ -143,7 +152,6 @@ protected:
 
 	void ShootButtonPressed();
 	void ShootButtonReleased();
-	void StartShootTimer();
 
 	void SelectButtonPressed();
 	void SelectButtonReleased();
@@ -161,11 +169,21 @@ protected:
 	// Detach weapon and let it fall
 	void DropWeapon();
 	
+	// Deprojects the centre of the screen into a world space ray
+	bool GetCrosshairRay(FVector& outStart, FVector& outDirection);
+
 	// Line trace for items under crosshair
 	bool TraceUnderCrosshair(FHitResult& outHitResult, FVector& outHitLocation, float traceRange);
 
 	// Check if overlapping items
 	void TraceForItems();
+
+	// Finds the items near the character through the pickup registry and grabs any ammo in reach
+	void QueryNearbyPickups();
+
+	// Moves the shared pickup widget onto the item and fills it in, hides it for NULL
+	void ShowPickupWidget(AItem* item);
+	void HidePickupWidget();
 	
 	// Initaialize the ammo map
 	void InitAmmoMap();
@@ -177,7 +195,28 @@ protected:
 
 	// Shoot Weapon Functions
 	void PlayShootSound();
-	void SendBullet();
+
+	// Fires every shot that became due this tick as one batch
+	void FireShots(TArrayView<const FScheduledShot> shots);
+	void SendBullets(TArrayView<const FScheduledShot> shots);
+
+	// Projectile weapons hand their rounds to the projectile subsystem instead of tracing
+	void LaunchProjectiles(TArrayView<const FScheduledShot> shots);
+
+	// Applies damage and impact effects for one hit along a bullets path
+	void ResolveBulletHit(const FHitscanShot& shot, const FHitResult& hitResult, float damageScale);
+
+	// Barrel socket of the equipped weapon in world space
+	FTransform GetMuzzleTransform() const;
+
+	// Runs the fire scheduler while a fire cycle is in progress
+	void UpdateFireScheduler();
+
+	// Fire cycle ended, frees up the combat state and reloads if the mag is empty
+	void FinishFireCycle();
+
+	// Fills the particle pools for this characters effects before the first shot
+	void PrewarmParticlePools();
 	void PlayGunFireMontage();
 
 	// Reload weapon
@@ -206,9 +245,6 @@ protected:
 	UFUNCTION(BlueprintCallable)
 	void EndStun();
 
-	UFUNCTION()
-	void AutoShootReset();
-
 	UFUNCTION()
 	void FinishCrosshairBulletFire();
 
@@ -281,6 +317,10 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat|Particles", meta = (AllowPrivateAccess = "true"))
 	UParticleSystem* bloodParticles;
 
+	// Components to pre-warm in the particle pool for each of the effects above
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat|Particles", meta = (AllowPrivateAccess = "true"))
+	int32 particlePoolPrewarmCount = 16;
+
 	// Montage for firing weapon
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat|Montages", meta = (AllowPrivateAccess = "true"))
 	UAnimMontage* hipFireMontage;
@@ -299,6 +339,9 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat|LineTrace", meta = (AllowPrivateAccess = "true"))
 	float itemTraceRange = 1000.f;
 
+	// Crosshair ray and trace shared by item tracing and firing for the current frame
+	FCrosshairQueryCache crosshairQuery;
+
 	// true when aiming
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Combat|LineTrace", meta = (AllowPrivateAccess = "true"))
 	bool bIsAiming = false;
@@ -353,14 +396,27 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Combat|LineTrace", meta = (AllowPrivateAccess = "true"))
 	bool bIsCrouching = false;
 	
-	// Sets timer between shots
-	FTimerHandle autoFireTimer;
+	// Times shots between ticks for the equipped weapon
+	FFireScheduler fireScheduler;
+
+	// Shots due this tick, kept around so firing doesnt allocate every frame
+	TArray<FScheduledShot> scheduledShots;
+
+	// Most shots fired in one tick, anything past this carries over to the next tick
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "true"))
+	int32 maxShotsPerTick = 32;
 
 	// True if we should trace
 	bool bShouldTraceForItems = false;
 
 	// Number of overlapped AItems
-	int8 overlappedItemCount;
+	int32 overlappedItemCount = 0;
+
+	// Number of items from the pickup registry within their pickup radius, refreshed every tick
+	int32 nearbyPickupCount = 0;
+
+	// Ammo within auto pickup range this tick
+	TArray<AItem*> autoPickups;
 
 	// Store refrence to item last frame
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Items", meta = (AllowPrivateAccess = "true"))
@@ -378,6 +434,26 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Combat", meta = (AllowPrivateAccess = "true"))
 	AItem* traceHitItem;
 
+	// Pickup popup for the traced item, replaces a widget component on every item
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Items", meta = (AllowPrivateAccess = "true"))
+	UWidgetComponent* pickupWidget;
+
+	// Popup to use for each item type
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Items", meta = (AllowPrivateAccess = "true"))
+	TMap<EItemType, TSubclassOf<UPickupWidget>> pickupWidgetClasses;
+
+	// Where the popup sits relative to the item
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Items", meta = (AllowPrivateAccess = "true"))
+	FVector pickupWidgetOffset = FVector(0.f, 0.f, 60.f);
+
+	// Created the first time an item of that type is looked at and reused after
+	UPROPERTY(Transient)
+	TMap<EItemType, UPickupWidget*> pickupWidgets;
+
+	// Item the popup is attached to
+	UPROPERTY(Transient)
+	AItem* pickupWidgetItem;
+
 	// CAMERA INTERPOLATION
 	/////////////////////////////////
 	// Distance outward from the camera for the interp destination
@@ -403,6 +479,10 @@ private:
 	// Amount of AR you start with
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Items|Ammo", meta = (AllowPrivateAccess = "true"))
 	int32 startingARAmmo = 120;
+
+	// Amount of shotgun shells you start with
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Items|Ammo", meta = (AllowPrivateAccess = "true"))
+	int32 startingShellsAmmo = 24;
 	///////////////////////////////
 
 	// Combat state can only fire or reload if unocupied
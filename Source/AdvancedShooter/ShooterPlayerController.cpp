@@ -3,10 +3,11 @@
 
 #include "ShooterPlayerController.h"
 #include <Components/WidgetComponent.h>
+#include <AdvancedShooter/Effects/DamageNumberComponent.h>
 
 AShooterPlayerController::AShooterPlayerController()
 {
-
+	damageNumbers = CreateDefaultSubobject<UDamageNumberComponent>(TEXT("DamageNumbers"));
 }
 
 void AShooterPlayerController::BeginPlay()
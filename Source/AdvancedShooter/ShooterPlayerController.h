@@ -7,6 +7,8 @@
 #include "ShooterPlayerController.generated.h"
 
 class UUserWidget;
+class UDamageNumberComponent;
+
 UCLASS()
 class ADVANCEDSHOOTER_API AShooterPlayerController : public APlayerController
 {
@@ -15,6 +17,8 @@ class ADVANCEDSHOOTER_API AShooterPlayerController : public APlayerController
 public:
 	AShooterPlayerController();
 
+	FORCEINLINE UDamageNumberComponent* GetDamageNumbers() const { return damageNumbers; }
+
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
@@ -28,4 +32,8 @@ private:
 	// Var to hold HUD overlay widget after creating it
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Widgets", meta = (AllowPrivateAccess = "true"))
 	UUserWidget* HUDOverlay;
+
+	// Pooled damage numbers for every enemy this player hits
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Widgets", meta = (AllowPrivateAccess = "true"))
+	UDamageNumberComponent* damageNumbers;
 };